@@ -19,7 +19,7 @@
 
 
 #include "PdV.h"
-#include "timer.h"
+#include "profiler.h"
 #include "comms.h"
 #include "report.h"
 #include "ideal_gas.h"
@@ -33,28 +33,28 @@
 //  level of the velocity data depends on whether it is invoked as the
 //  predictor or corrector.
 void PdV_kernel(
+  const exec_space& space,
   bool predict,
   int x_min, int x_max, int y_min, int y_max,
   double dt,
-  Kokkos::View<double**>& xarea,
-  Kokkos::View<double**>& yarea,
-  Kokkos::View<double**>& volume,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& yvel1,
-  Kokkos::View<double**>& volume_change) {
+  field_view& xarea,
+  field_view& yarea,
+  field_view& volume,
+  field_view& density0,
+  field_view& density1,
+  field_view& energy0,
+  field_view& energy1,
+  field_view& pressure,
+  work_view& viscosity,
+  field_view& xvel0,
+  field_view& xvel1,
+  field_view& yvel0,
+  field_view& yvel1) {
 
 
   // DO k=y_min,y_max
   //   DO j=x_min,x_max  
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min+1, y_min+1}, {x_max+2, y_max+2});
+  field_policy policy(space, {x_min+1, y_min+1}, {x_max+2, y_max+2});
 
   if (predict) {
 
@@ -132,13 +132,42 @@ void PdV_kernel(
 
 
 
+//  @brief PdV update of one tile.
+//  @details Runs the kernel over the tile grown by ring cells into its halo.
+void PdV_tile(global_variables& globals, int tile, bool predict, int ring) {
+
+  int x_min, x_max, y_min, y_max;
+  redundant_bounds(globals, tile, ring, x_min, x_max, y_min, y_max);
+
+  PdV_kernel(
+    globals.tiles[tile].space,
+    predict,
+    x_min,
+    x_max,
+    y_min,
+    y_max,
+    globals.dt,
+    globals.tiles[tile].field.xarea,
+    globals.tiles[tile].field.yarea,
+    globals.tiles[tile].field.volume,
+    globals.tiles[tile].field.density0,
+    globals.tiles[tile].field.density1,
+    globals.tiles[tile].field.energy0,
+    globals.tiles[tile].field.energy1,
+    globals.tiles[tile].field.pressure,
+    globals.tiles[tile].field.viscosity,
+    globals.tiles[tile].field.xvel0,
+    globals.tiles[tile].field.xvel1,
+    globals.tiles[tile].field.yvel0,
+    globals.tiles[tile].field.yvel1);
+}
+
 //  @brief Driver for the PdV update.
 //  @author Wayne Gaudin
 //  @details Invokes the user specified kernel for the PdV update.
 void PdV(global_variables& globals, bool predict) {
 
-  double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
+  double kernel_time = profiler_start(globals, "PdV");
 
   globals.error_condition = 0;
 
@@ -150,56 +179,53 @@ void PdV(global_variables& globals, bool predict) {
     prdct = 1;
   }
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-    PdV_kernel(
-      predict,
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.dt,
-      globals.chunk.tiles[tile].field.xarea,
-      globals.chunk.tiles[tile].field.yarea,
-      globals.chunk.tiles[tile].field.volume,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.tiles[tile].field.work_array1);
+  // With a deep halo the predictor also runs over the first halo cell, so
+  // that the pressure there needs no exchange
+  const int ring = (predict && globals.halo_depth > 2) ? 1 : 0;
 
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    PdV_tile(globals, tile, predict, ring);
   }
 
   clover_check_error(globals.error_condition);
-  if (globals.profiler_on) globals.profiler.PdV += timer() - kernel_time;
+  profiler_stop(globals, globals.profiler.PdV, kernel_time);
 
   if (globals.error_condition == 1) {
     report_error((char *)"PdV", (char *)"error in PdV");
   }
 
   if (predict) {
-    if (globals.profiler_on) kernel_time = timer();
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      ideal_gas(globals, tile, true);
+    kernel_time = profiler_start(globals, "ideal_gas");
+    for (int tile = 0; tile < globals.local_tiles; ++tile) {
+      ideal_gas(globals, tile, true, ring);
     }
 
-    if (globals.profiler_on) globals.profiler.ideal_gas += timer() - kernel_time;
+    profiler_stop(globals, globals.profiler.ideal_gas, kernel_time);
 
     int fields[NUM_FIELDS];
     for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
+
+    if (globals.overlap_halo && globals.halo_depth == 2) {
+      // Finish the viscosity halo exchange started by the timestep, which the
+      // predictor and equation of state above have overlapped
+      fields[field_viscosity] = 1;
+      update_halo_finish(globals, fields, 1);
+      fields[field_viscosity] = 0;
+    }
+
     fields[field_pressure] = 1;
-    update_halo(globals, fields, 1);
+    if (ring > 0) {
+      update_halo_reflect(globals, fields, 1);
+    }
+    else {
+      update_halo(globals, fields, 1);
+    }
   }
 
   if (predict) {
-    if (globals.profiler_on) kernel_time = timer();
+    kernel_time = profiler_start(globals, "revert");
     revert(globals);
-    if (globals.profiler_on) globals.profiler.revert += timer() - kernel_time;
+    profiler_stop(globals, globals.profiler.revert, kernel_time);
   }
 
 }
@@ -24,6 +24,7 @@
 #include "definitions.h"
 
 void PdV(global_variables& globals, bool predict);
+void PdV_tile(global_variables& globals, int tile, bool predict, int ring);
 
 #endif
 
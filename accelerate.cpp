@@ -19,31 +19,33 @@
 
 
 #include "accelerate.h"
-#include "timer.h"
+#include "profiler.h"
+#include "update_halo.h"
 
 // @brief Fortran acceleration kernel
 // @author Wayne Gaudin
 // @details The pressure and viscosity gradients are used to update the 
 // velocity field.
 void accelerate_kernel(
+  const exec_space& space,
   int x_min, int x_max, int y_min, int y_max,
   double dt,
-  Kokkos::View<double**>& xarea,
-  Kokkos::View<double**>& yarea,
-  Kokkos::View<double**>& volume,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel1) {
+  field_view& xarea,
+  field_view& yarea,
+  field_view& volume,
+  field_view& density0,
+  field_view& pressure,
+  work_view& viscosity,
+  field_view& xvel0,
+  field_view& yvel0,
+  field_view& xvel1,
+  field_view& yvel1) {
 
   double halfdt = 0.5 * dt;
 
   // DO k=y_min,y_max+1
   //   DO j=x_min,x_max+1
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min+1, y_min+1}, {x_max+1+2, y_max+1+2});
+  field_policy policy(space, {x_min+1, y_min+1}, {x_max+1+2, y_max+1+2});
   Kokkos::parallel_for("accelerate", policy, KOKKOS_LAMBDA (const int j, const int k) {
     double stepbymass_s = halfdt / ((density0(j-1,k-1) * volume(j-1,k-1)
       + density0(j  ,k-1) * volume(j  ,k-1)
@@ -63,35 +65,45 @@ void accelerate_kernel(
 }
 
 
+//  @brief Acceleration of one tile.
+//  @details Runs the kernel over the tile grown by ring cells into its halo.
+void accelerate_tile(global_variables& globals, int tile, int ring) {
+
+  int x_min, x_max, y_min, y_max;
+  redundant_bounds(globals, tile, ring, x_min, x_max, y_min, y_max);
+
+  accelerate_kernel(
+    globals.tiles[tile].space,
+    x_min,
+    x_max,
+    y_min,
+    y_max,
+    globals.dt,
+    globals.tiles[tile].field.xarea,
+    globals.tiles[tile].field.yarea,
+    globals.tiles[tile].field.volume,
+    globals.tiles[tile].field.density0,
+    globals.tiles[tile].field.pressure,
+    globals.tiles[tile].field.viscosity,
+    globals.tiles[tile].field.xvel0,
+    globals.tiles[tile].field.yvel0,
+    globals.tiles[tile].field.xvel1,
+    globals.tiles[tile].field.yvel1);
+}
+
 //  @brief Driver for the acceleration kernels
 //  @author Wayne Gaudin
 //  @details Calls user requested kernel
 void accelerate(global_variables& globals) {
 
-  double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
-
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-
-    accelerate_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.dt,
-      globals.chunk.tiles[tile].field.xarea,
-      globals.chunk.tiles[tile].field.yarea,
-      globals.chunk.tiles[tile].field.volume,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.tiles[tile].field.yvel1);
+  double kernel_time = profiler_start(globals, "acceleration");
+
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+
+    accelerate_tile(globals, tile, 0);
 
   }
   
-  if (globals.profiler_on) globals.profiler.acceleration += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.acceleration, kernel_time);
 
 }
@@ -24,6 +24,7 @@
 #include "definitions.h"
 
 void accelerate(global_variables& globals);
+void accelerate_tile(global_variables& globals, int tile, int ring);
 
 #endif
 
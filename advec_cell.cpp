@@ -19,248 +19,318 @@
 
 
 #include "advec_cell.h"
+#include "scratch.h"
+#include "update_halo.h"
+
+//  @brief Pre-advection cell volume
+//  @details Volume of a cell before the remap in the given direction and
+//  sweep. vol_flux is the volume flux along the sweep and vol_flux_across the
+//  one across it.
+template <int dir, int sweep_number>
+KOKKOS_INLINE_FUNCTION
+double advec_cell_pre_vol(const int j, const int k,
+  const field_view& volume,
+  const field_view& vol_flux,
+  const field_view& vol_flux_across) {
+
+  const int across = (dir == g_xdir) ? g_ydir : g_xdir;
+  const int i = (dir == g_xdir) ? j : k;
+  const int c = (dir == g_xdir) ? k : j;
+
+  if (sweep_number == 1) {
+    return volume(j,k)+(advec_along<dir>(vol_flux,j,k,i+1)-vol_flux(j,k)+advec_along<across>(vol_flux_across,j,k,c+1)-vol_flux_across(j,k));
+  }
+  return volume(j,k)+advec_along<dir>(vol_flux,j,k,i+1)-vol_flux(j,k);
+}
+
+//  @brief Pre and post advection volumes over a block of cells.
+//  @details The block is given by inclusive Fortran bounds and is skipped
+//  when empty.
+template <int dir, int sweep_number>
+void advec_cell_volumes(const exec_space& space, const std::string& name,
+  int j0, int j1, int k0, int k1,
+  field_view& volume,
+  field_view& vol_flux,
+  field_view& vol_flux_across,
+  work_view& pre_vol,
+  work_view& post_vol) {
+
+  if (j1 < j0 || k1 < k0) return;
+
+  // DO k=k0,k1
+  //   DO j=j0,j1
+  field_policy policy(space, {j0+1, k0+1}, {j1+2, k1+2});
+  Kokkos::parallel_for(name + " pre_vol", policy, KOKKOS_LAMBDA (const int j, const int k) {
+      const int i = (dir == g_xdir) ? j : k;
+      pre_vol(j,k) = advec_cell_pre_vol<dir,sweep_number>(j, k, volume, vol_flux, vol_flux_across);
+      if (sweep_number == 1) {
+        post_vol(j,k) = pre_vol(j,k)-(advec_along<dir>(vol_flux,j,k,i+1)-vol_flux(j,k));
+      }
+      else {
+        post_vol(j,k) = volume(j,k);
+      }
+  });
+}
+
+//  @brief Mass and energy fluxes over a block of faces.
+//  @details The block is given by inclusive Fortran bounds and is skipped
+//  when empty. i_max is the last cell along the sweep, which clamps the
+//  upwind cell.
+template <int dir, int sweep_number, bool fused>
+void advec_cell_flux(const exec_space& space, const std::string& name,
+  int j0, int j1, int k0, int k1, int i_max,
+  Kokkos::View<double*>& vertexd,
+  field_view& volume,
+  field_view& density1,
+  field_view& energy1,
+  field_view& mass_flux,
+  field_view& vol_flux,
+  field_view& vol_flux_across,
+  work_view& pre_vol,
+  work_view& ener_flux) {
+
+  if (j1 < j0 || k1 < k0) return;
+
+  const double one_by_six = 1.0/6.0;
+
+  // DO k=k0,k1
+  //   DO j=j0,j1
+  field_policy policy_flux(space, {j0+1, k0+1}, {j1+2, k1+2});
+  Kokkos::parallel_for(name + " ener_flux", policy_flux, KOKKOS_LAMBDA (const int j, const int k) {
+
+      const int i = (dir == g_xdir) ? j : k;
+
+      int upwind, donor, downwind, dif;
+      double sigmat, sigma3, sigma4, sigmav, sigmam, diffuw, diffdw, limiter, wind;
+
+      if (vol_flux(j,k) > 0.0) {
+        upwind   =i-2;
+        donor    =i-1;
+        downwind =i;
+        dif      =donor;
+      }
+      else {
+        upwind   =MIN(i+1,i_max+2+1);
+        donor    =i;
+        downwind =i-1;
+        dif      =upwind;
+      }
+
+      double pre_vol_donor;
+      if (fused) {
+        pre_vol_donor = advec_cell_pre_vol<dir,sweep_number>((dir == g_xdir) ? donor : j, (dir == g_xdir) ? k : donor,
+          volume, vol_flux, vol_flux_across);
+      }
+      else {
+        pre_vol_donor = advec_along<dir>(pre_vol,j,k,donor);
+      }
+
+      const double density_donor = advec_along<dir>(density1,j,k,donor);
+      const double energy_donor = advec_along<dir>(energy1,j,k,donor);
+
+      sigmat=fabs(vol_flux(j,k))/pre_vol_donor;
+      sigma3=(1.0+sigmat)*(vertexd(i)/vertexd(dif));
+      sigma4=2.0-sigmat;
+
+      sigmav=sigmat;
+
+      diffuw=density_donor-advec_along<dir>(density1,j,k,upwind);
+      diffdw=advec_along<dir>(density1,j,k,downwind)-density_donor;
+      wind=1.0;
+      if (diffdw <= 0.0) wind=-1.0;
+      if (diffuw*diffdw > 0.0) {
+        limiter=(1.0-sigmav)*wind*MIN(MIN(fabs(diffuw),fabs(diffdw)),one_by_six*(sigma3*fabs(diffuw)+sigma4*fabs(diffdw)));
+      }
+      else {
+        limiter=0.0;
+      }
+      double mass_flux_s=vol_flux(j,k)*(density_donor+limiter);
+      mass_flux(j,k)=mass_flux_s;
+
+      sigmam=fabs(mass_flux_s)/(density_donor*pre_vol_donor);
+      diffuw=energy_donor-advec_along<dir>(energy1,j,k,upwind);
+      diffdw=advec_along<dir>(energy1,j,k,downwind)-energy_donor;
+      wind=1.0;
+      if (diffdw <= 0.0) wind=-1.0;
+      if (diffuw*diffdw > 0.0) {
+        limiter=(1.0-sigmam)*wind*MIN(MIN(fabs(diffuw),fabs(diffdw)),one_by_six*(sigma3*fabs(diffuw)+sigma4*fabs(diffdw)));
+      }
+      else {
+        limiter=0.0;
+      }
+
+      ener_flux(j,k)=mass_flux_s*(energy_donor+limiter);
+  });
+}
 
 //  @brief Fortran cell advection kernel.
 //  @author Wayne Gaudin
 //  @details Performs a second order advective remap using van-Leer limiting
-//  with directional splitting.
+//  with directional splitting. The direction and sweep are template
+//  parameters, so one implementation serves both directions with the index
+//  offsets known at compile time. The fields passed in are those along the
+//  sweep. When fused, pre_vol is recomputed from the volume fluxes where it is
+//  needed instead of being written by a separate pass; both give identical
+//  results. The interior part computes the volumes of the chunk cells and the
+//  fluxes whose stencils lie inside the chunk, so it reads no halo cells; the
+//  boundary part computes the rest and updates the fields.
+template <int dir, int sweep_number, bool fused>
 void advec_cell_kernel(
+  const exec_space& space,
+  overlap_part part,
   int x_min,
   int x_max,
   int y_min,
   int y_max,
-  int dir,
-  int sweep_number,
-  Kokkos::View<double*>& vertexdx,
-  Kokkos::View<double*>& vertexdy,
-  Kokkos::View<double**>& volume,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& mass_flux_x,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& mass_flux_y,
-  Kokkos::View<double**>& vol_flux_y,
-  Kokkos::View<double**>& pre_vol,
-  Kokkos::View<double**>& post_vol,
-  Kokkos::View<double**>& pre_mass,
-  Kokkos::View<double**>& post_mass,
-  Kokkos::View<double**>& advec_vol,
-  Kokkos::View<double**>& post_ener,
-  Kokkos::View<double**>& ener_flux) {
-
-  const double one_by_six = 1.0/6.0;
-
-  if (dir == g_xdir) {
-
-    // DO k=y_min-2,y_max+2
-    //   DO j=x_min-2,x_max+2
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min-2+1, y_min-2+1}, {x_max+2+2, y_max+2+2});
-
-    if (sweep_number ==  1) {
-      Kokkos::parallel_for("advec_cell xdir sweep_number=1", policy, KOKKOS_LAMBDA (const int j, const int k) {
-
-          pre_vol(j,k)  = volume(j,k)+(vol_flux_x(j+1,k  )-vol_flux_x(j,k)+vol_flux_y(j  ,k+1)-vol_flux_y(j,k));
-          post_vol(j,k) = pre_vol(j,k)-(vol_flux_x(j+1,k  )-vol_flux_x(j,k));
-      });
+  Kokkos::View<double*>& vertexd,
+  field_view& volume,
+  field_view& density1,
+  field_view& energy1,
+  field_view& mass_flux,
+  field_view& vol_flux,
+  field_view& vol_flux_across,
+  work_view& pre_vol,
+  work_view& post_vol,
+  work_view& ener_flux) {
+
+  // Unit offsets along the sweep
+  const int dj = (dir == g_xdir) ? 1 : 0;
+  const int dk = 1-dj;
+  const int i_max = (dir == g_xdir) ? x_max : y_max;
+
+  const std::string name = (dir == g_xdir) ? "advec_cell xdir" : "advec_cell ydir";
+
+  if (!fused) {
+    if (part == overlap_all) {
+      advec_cell_volumes<dir,sweep_number>(space, name, x_min-2, x_max+2, y_min-2, y_max+2,
+        volume, vol_flux, vol_flux_across, pre_vol, post_vol);
+    }
+    else if (part == overlap_interior) {
+      advec_cell_volumes<dir,sweep_number>(space, name, x_min, x_max, y_min, y_max,
+        volume, vol_flux, vol_flux_across, pre_vol, post_vol);
     }
     else {
-      Kokkos::parallel_for("advec_cell xdir sweep_number!=1", policy, KOKKOS_LAMBDA (const int j, const int k) {
-          pre_vol(j,k)  = volume(j,k)+vol_flux_x(j+1,k)-vol_flux_x(j,k);
-          post_vol(j,k) = volume(j,k);
-      });
+      advec_cell_volumes<dir,sweep_number>(space, name, x_min-2, x_max+2, y_min-2, y_min-1,
+        volume, vol_flux, vol_flux_across, pre_vol, post_vol);
+      advec_cell_volumes<dir,sweep_number>(space, name, x_min-2, x_max+2, y_max+1, y_max+2,
+        volume, vol_flux, vol_flux_across, pre_vol, post_vol);
+      advec_cell_volumes<dir,sweep_number>(space, name, x_min-2, x_min-1, y_min, y_max,
+        volume, vol_flux, vol_flux_across, pre_vol, post_vol);
+      advec_cell_volumes<dir,sweep_number>(space, name, x_max+1, x_max+2, y_min, y_max,
+        volume, vol_flux, vol_flux_across, pre_vol, post_vol);
     }
-
-    // DO k=y_min,y_max
-    //   DO j=x_min,x_max+2
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy_x2({x_min+1, y_min+1}, {x_max+2+2, y_max+2});
-    Kokkos::parallel_for("advec_cell xdir ener_flux", policy_x2, KOKKOS_LAMBDA (const int j, const int k) {
-
-        int upwind, donor, downwind, dif;
-        double sigmat, sigma3, sigma4, sigmav, sigma, sigmam, diffuw, diffdw, limiter, wind;
-
-        if (vol_flux_x(j,k) > 0.0) {
-          upwind   =j-2;
-          donor    =j-1;
-          downwind =j;
-          dif      =donor;
-        }
-        else {
-          upwind   =MIN(j+1,x_max+2);
-          donor    =j;
-          downwind =j-1;
-          dif      =upwind;
-        }
-
-
-        sigmat=fabs(vol_flux_x(j,k))/pre_vol(donor,k);
-        sigma3=(1.0+sigmat)*(vertexdx(j)/vertexdx(dif));
-        sigma4=2.0-sigmat;
-
-        sigma=sigmat;
-        sigmav=sigmat;
-
-        diffuw=density1(donor,k)-density1(upwind,k);
-        diffdw=density1(downwind,k)-density1(donor,k);
-        wind=1.0;
-        if (diffdw <= 0.0) wind=-1.0;
-        if (diffuw*diffdw > 0.0) {
-          limiter=(1.0-sigmav)*wind*MIN(MIN(fabs(diffuw),fabs(diffdw)),one_by_six*(sigma3*fabs(diffuw)+sigma4*fabs(diffdw)));
-        }
-        else {
-          limiter=0.0;
-        }
-        mass_flux_x(j,k)=vol_flux_x(j,k)*(density1(donor,k)+limiter);
-
-        sigmam=fabs(mass_flux_x(j,k))/(density1(donor,k)*pre_vol(donor,k));
-        diffuw=energy1(donor,k)-energy1(upwind,k);
-        diffdw=energy1(downwind,k)-energy1(donor,k);
-        wind=1.0;
-        if (diffdw <= 0.0) wind=-1.0;
-        if (diffuw*diffdw > 0.0) {
-          limiter=(1.0-sigmam)*wind*MIN(MIN(fabs(diffuw),fabs(diffdw)),one_by_six*(sigma3*fabs(diffuw)+sigma4*fabs(diffdw)));
-        }
-        else {
-          limiter=0.0;
-        }
-
-        ener_flux(j,k)=mass_flux_x(j,k)*(energy1(donor,k)+limiter);
-    });
-
-
-    // DO k=y_min,y_max
-    //   DO j=x_min,x_max
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy_xy({x_min+1, y_min+1}, {x_max+2, y_max+2});
-    Kokkos::parallel_for("advec_cell xdir density1,energy1", policy_xy, KOKKOS_LAMBDA (const int j, const int k) {
-        double pre_mass_s=density1(j,k)*pre_vol(j,k);
-        double post_mass_s=pre_mass_s+mass_flux_x(j,k)-mass_flux_x(j+1,k);
-        double post_ener_s=(energy1(j,k)*pre_mass_s+ener_flux(j,k)-ener_flux(j+1,k))/post_mass_s;
-        double advec_vol_s=pre_vol(j,k)+vol_flux_x(j,k)-vol_flux_x(j+1,k);
-        density1(j,k)=post_mass_s/advec_vol_s;
-        energy1(j,k)=post_ener_s;
-    });
   }
 
-  else if (dir == g_ydir) {
+  // Faces run from x_min to x_max+2 along an x sweep and y_min to y_max+2
+  // along a y sweep. Those from the third to the second last read only chunk
+  // cells.
+  if (part == overlap_all) {
+    advec_cell_flux<dir,sweep_number,fused>(space, name, x_min, x_max+2*dj, y_min, y_max+2*dk, i_max,
+      vertexd, volume, density1, energy1, mass_flux, vol_flux, vol_flux_across, pre_vol, ener_flux);
+  }
+  else if (part == overlap_interior) {
+    advec_cell_flux<dir,sweep_number,fused>(space, name, x_min+2*dj, x_max-dj, y_min+2*dk, y_max-dk, i_max,
+      vertexd, volume, density1, energy1, mass_flux, vol_flux, vol_flux_across, pre_vol, ener_flux);
+  }
+  else {
+    advec_cell_flux<dir,sweep_number,fused>(space, name, x_min, dj ? x_min+1 : x_max, y_min, dk ? y_min+1 : y_max, i_max,
+      vertexd, volume, density1, energy1, mass_flux, vol_flux, vol_flux_across, pre_vol, ener_flux);
+    advec_cell_flux<dir,sweep_number,fused>(space, name, dj ? x_max : x_min, x_max+2*dj, dk ? y_max : y_min, y_max+2*dk, i_max,
+      vertexd, volume, density1, energy1, mass_flux, vol_flux, vol_flux_across, pre_vol, ener_flux);
+  }
 
-    // DO k=y_min-2,y_max+2
-    //   DO j=x_min-2,x_max+2
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min-2+1, y_min-2+1}, {x_max+2+2, y_max+2+2});
+  if (part == overlap_interior) return;
+
+  // DO k=y_min,y_max
+  //   DO j=x_min,x_max
+  field_policy policy_xy(space, {x_min+1, y_min+1}, {x_max+2, y_max+2});
+  Kokkos::parallel_for(name + " density1,energy1", policy_xy, KOKKOS_LAMBDA (const int j, const int k) {
+      const int i = (dir == g_xdir) ? j : k;
+      double pre_vol_s;
+      if (fused) {
+        pre_vol_s=advec_cell_pre_vol<dir,sweep_number>(j, k, volume, vol_flux, vol_flux_across);
+      }
+      else {
+        pre_vol_s=pre_vol(j,k);
+      }
+      double pre_mass_s=density1(j,k)*pre_vol_s;
+      double post_mass_s=pre_mass_s+mass_flux(j,k)-advec_along<dir>(mass_flux,j,k,i+1);
+      double post_ener_s=(energy1(j,k)*pre_mass_s+ener_flux(j,k)-advec_along<dir>(ener_flux,j,k,i+1))/post_mass_s;
+      double advec_vol_s=pre_vol_s+vol_flux(j,k)-advec_along<dir>(vol_flux,j,k,i+1);
+      density1(j,k)=post_mass_s/advec_vol_s;
+      energy1(j,k)=post_ener_s;
+  });
 
-    if (sweep_number == 1) {
-      Kokkos::parallel_for("advec_cell ydir sweep_number=1", policy, KOKKOS_LAMBDA (const int j, const int k) {
+}
 
-          pre_vol(j,k)=volume(j,k)+(vol_flux_y(j  ,k+1)-vol_flux_y(j,k)+vol_flux_x(j+1,k  )-vol_flux_x(j,k));
-          post_vol(j,k)=pre_vol(j,k)-(vol_flux_y(j  ,k+1)-vol_flux_y(j,k));
-      });
-    }
-    else {
-      Kokkos::parallel_for("advec_cell ydir sweep_number!=1", policy, KOKKOS_LAMBDA (const int j, const int k) {
-          pre_vol(j,k)=volume(j,k)+vol_flux_y(j  ,k+1)-vol_flux_y(j,k);
-          post_vol(j,k)=volume(j,k);
-      });
-    }
 
-    // DO k=y_min,y_max+2
-    //   DO j=x_min,x_max
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy_y2({x_min+1, y_min+1}, {x_max+2, y_max+2+2});
-    Kokkos::parallel_for("advec_cell ydir ener_flux", policy_y2, KOKKOS_LAMBDA (const int j, const int k) {
-
-        int upwind, donor, downwind, dif;
-        double sigmat, sigma3, sigma4, sigmav, sigma, sigmam, diffuw, diffdw, limiter, wind;
-
-        if (vol_flux_y(j,k) > 0.0) {
-          upwind   =k-2;
-          donor    =k-1;
-          downwind =k;
-          dif      =donor;
-        }
-        else {
-          upwind   =MIN(k+1,y_max+2);
-          donor    =k;
-          downwind =k-1;
-          dif      =upwind;
-        }
-
-        sigmat=fabs(vol_flux_y(j,k))/pre_vol(j,donor);
-        sigma3=(1.0+sigmat)*(vertexdy(k)/vertexdy(dif));
-        sigma4=2.0-sigmat;
-
-        sigma=sigmat;
-        sigmav=sigmat;
-
-        diffuw=density1(j,donor)-density1(j,upwind);
-        diffdw=density1(j,downwind)-density1(j,donor);
-        wind=1.0;
-        if (diffdw <= 0.0) wind=-1.0;
-        if (diffuw*diffdw > 0.0) {
-          limiter=(1.0-sigmav)*wind*MIN(MIN(fabs(diffuw),fabs(diffdw)),
-            one_by_six*(sigma3*fabs(diffuw)+sigma4*fabs(diffdw)));
-        }
-        else {
-          limiter=0.0;
-        }
-        mass_flux_y(j,k)=vol_flux_y(j,k)*(density1(j,donor)+limiter);
-
-        sigmam=fabs(mass_flux_y(j,k))/(density1(j,donor)*pre_vol(j,donor));
-        diffuw=energy1(j,donor)-energy1(j,upwind);
-        diffdw=energy1(j,downwind)-energy1(j,donor);
-        wind=1.0;
-        if (diffdw <= 0.0) wind=-1.0;
-        if (diffuw*diffdw > 0.0) {
-          limiter=(1.0-sigmam)*wind*MIN(MIN(fabs(diffuw),fabs(diffdw)),
-            one_by_six*(sigma3*fabs(diffuw)+sigma4*fabs(diffdw)));
-        }
-        else {
-          limiter=0.0;
-        }
-        ener_flux(j,k)=mass_flux_y(j,k)*(energy1(j,donor)+limiter);
-    });
-
-    // DO k=y_min,y_max
-    //   DO j=x_min,x_max
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy_xy({x_min+1, y_min+1}, {x_max+2, y_max+2});
-    Kokkos::parallel_for("advec_cell ydir density1,energy1", policy_xy, KOKKOS_LAMBDA (const int j, const int k) {
-
-        double pre_mass_s=density1(j,k)*pre_vol(j,k);
-        double post_mass_s=pre_mass_s+mass_flux_y(j,k)-mass_flux_y(j,k+1);
-        double post_ener_s=(energy1(j,k)*pre_mass_s+ener_flux(j,k)-ener_flux(j,k+1))/post_mass_s;
-        double advec_vol_s=pre_vol(j,k)+vol_flux_y(j,k)-vol_flux_y(j,k+1);
-        density1(j,k)=post_mass_s/advec_vol_s;
-        energy1(j,k)=post_ener_s;
-    });
+//  @brief Cell centred advection for one direction and sweep.
+//  @details Passes the fields along the sweep to the kernel and selects the
+//  fused or unfused variant.
+template <int dir, int sweep_number>
+void advec_cell_tile(global_variables& globals, int tile, overlap_part part, int ring) {
+
+  field_type& field = globals.tiles[tile].field;
+
+  int x_min, x_max, y_min, y_max;
+  redundant_bounds(globals, tile, ring, x_min, x_max, y_min, y_max);
+
+  if (globals.fused_advec_cell) {
+    advec_cell_kernel<dir, sweep_number, true>(
+      globals.tiles[tile].space,
+      part,
+      x_min,
+      x_max,
+      y_min,
+      y_max,
+      (dir == g_xdir) ? field.vertexdx : field.vertexdy,
+      field.volume,
+      field.density1,
+      field.energy1,
+      (dir == g_xdir) ? field.mass_flux_x : field.mass_flux_y,
+      (dir == g_xdir) ? field.vol_flux_x : field.vol_flux_y,
+      (dir == g_xdir) ? field.vol_flux_y : field.vol_flux_x,
+      scratch(globals, tile, scratch_cell_pre_vol),
+      scratch(globals, tile, scratch_cell_post_vol),
+      scratch(globals, tile, scratch_ener_flux));
+  }
+  else {
+    advec_cell_kernel<dir, sweep_number, false>(
+      globals.tiles[tile].space,
+      part,
+      x_min,
+      x_max,
+      y_min,
+      y_max,
+      (dir == g_xdir) ? field.vertexdx : field.vertexdy,
+      field.volume,
+      field.density1,
+      field.energy1,
+      (dir == g_xdir) ? field.mass_flux_x : field.mass_flux_y,
+      (dir == g_xdir) ? field.vol_flux_x : field.vol_flux_y,
+      (dir == g_xdir) ? field.vol_flux_y : field.vol_flux_x,
+      scratch(globals, tile, scratch_cell_pre_vol),
+      scratch(globals, tile, scratch_cell_post_vol),
+      scratch(globals, tile, scratch_ener_flux));
   }
-
 }
 
 
 //  @brief Cell centred advection driver.
 //  @author Wayne Gaudin
-//  @details Invokes the user selected advection kernel.
-void advec_cell_driver(global_variables& globals, int tile, int sweep_number, int direction) {
-
-  advec_cell_kernel(
-    globals.chunk.tiles[tile].t_xmin,
-    globals.chunk.tiles[tile].t_xmax,
-    globals.chunk.tiles[tile].t_ymin,
-    globals.chunk.tiles[tile].t_ymax,
-    direction,
-    sweep_number,
-    globals.chunk.tiles[tile].field.vertexdx,
-    globals.chunk.tiles[tile].field.vertexdy,
-    globals.chunk.tiles[tile].field.volume,
-    globals.chunk.tiles[tile].field.density1,
-    globals.chunk.tiles[tile].field.energy1,
-    globals.chunk.tiles[tile].field.mass_flux_x,
-    globals.chunk.tiles[tile].field.vol_flux_x,
-    globals.chunk.tiles[tile].field.mass_flux_y,
-    globals.chunk.tiles[tile].field.vol_flux_y,
-    globals.chunk.tiles[tile].field.work_array1,
-    globals.chunk.tiles[tile].field.work_array2,
-    globals.chunk.tiles[tile].field.work_array3,
-    globals.chunk.tiles[tile].field.work_array4,
-    globals.chunk.tiles[tile].field.work_array5,
-    globals.chunk.tiles[tile].field.work_array6,
-    globals.chunk.tiles[tile].field.work_array7);
+//  @details Invokes the user selected advection kernel, specialised for the
+//  direction and sweep, over the requested part of the tile grown by ring
+//  cells into the halo.
+void advec_cell_driver(global_variables& globals, int tile, int sweep_number, int direction, overlap_part part, int ring) {
+
+  if (direction == g_xdir) {
+    if (sweep_number == 1) advec_cell_tile<g_xdir, 1>(globals, tile, part, ring);
+    else                   advec_cell_tile<g_xdir, 2>(globals, tile, part, ring);
+  }
+  else if (direction == g_ydir) {
+    if (sweep_number == 1) advec_cell_tile<g_ydir, 1>(globals, tile, part, ring);
+    else                   advec_cell_tile<g_ydir, 2>(globals, tile, part, ring);
+  }
 
 }
 
@@ -23,7 +23,7 @@
 
 #include "definitions.h"
 
-void advec_cell_driver(global_variables& globals, int tile, int sweep_number, int direction);
+void advec_cell_driver(global_variables& globals, int tile, int sweep_number, int direction, overlap_part part, int ring);
 
 #endif
 
@@ -19,269 +19,345 @@
 
 
 #include "advec_mom.h"
+#include "scratch.h"
+#include "update_halo.h"
+
+//  @brief Post-advection cell volume
+//  @details Volume of a cell after the remap across the sweep, for the given
+//  direction and sweep. vol_flux_across is the volume flux across the sweep.
+template <int dir, int sweep_number>
+KOKKOS_INLINE_FUNCTION
+double advec_mom_post_vol(const int j, const int k,
+  const field_view& volume,
+  const field_view& vol_flux_across) {
+
+  const int across = (dir == g_xdir) ? g_ydir : g_xdir;
+  const int c = (dir == g_xdir) ? k : j;
+
+  if (sweep_number == 1) {
+    return volume(j,k)+advec_along<across>(vol_flux_across,j,k,c+1)-vol_flux_across(j,k);
+  }
+  return volume(j,k);
+}
+
+//  @brief Momentum flux through a node face along the sweep
+//  @details Van-Leer limited upwind estimate of the velocity carried by the
+//  node flux, times that flux. celld is the cell width along the sweep.
+template <int dir>
+KOKKOS_INLINE_FUNCTION
+double advec_mom_flux(const int j, const int k,
+  const field_view& vel1,
+  const work_view& node_flux,
+  const work_view& node_mass_pre,
+  const Kokkos::View<double*>& celld) {
+
+  const int i = (dir == g_xdir) ? j : k;
+
+  int upwind, donor, downwind, dif;
+  double sigma, width, limiter, vdiffuw, vdiffdw, auw, adw, wind, advec_vel_s;
+
+  if (node_flux(j,k) < 0.0) {
+    upwind=i+2;
+    donor=i+1;
+    downwind=i;
+    dif=donor;
+  }
+  else {
+    upwind=i-1;
+    donor=i;
+    downwind=i+1;
+    dif=upwind;
+  }
+
+  const double vel_donor = advec_along<dir>(vel1,j,k,donor);
+
+  sigma=fabs(node_flux(j,k))/(advec_along<dir>(node_mass_pre,j,k,donor));
+  width=celld(i);
+  vdiffuw=vel_donor-advec_along<dir>(vel1,j,k,upwind);
+  vdiffdw=advec_along<dir>(vel1,j,k,downwind)-vel_donor;
+  limiter=0.0;
+  if (vdiffuw*vdiffdw > 0.0) {
+    auw=fabs(vdiffuw);
+    adw=fabs(vdiffdw);
+    wind=1.0;
+    if (vdiffdw <= 0.0) wind=-1.0;
+    limiter=wind*MIN(MIN(width*((2.0-sigma)*adw/width+(1.0+sigma)*auw/celld(dif))/6.0,auw),adw);
+  }
+  advec_vel_s=vel_donor+(1.0-sigma)*limiter;
+  return advec_vel_s*node_flux(j,k);
+}
+
+//  @brief Staggered mesh mass flux and node masses
+//  @details Builds node_flux, node_mass_post and node_mass_pre for a sweep.
+//  These depend only on the direction and sweep, not on the velocity being
+//  advected. When fused, post_vol is computed on the fly instead of being
+//  read back from the work array.
+template <int dir, int sweep_number, bool fused>
+void advec_mom_node(
+  const exec_space& space,
+  int x_min, int x_max, int y_min, int y_max,
+  field_view& mass_flux,
+  field_view& vol_flux_across,
+  field_view& volume,
+  field_view& density1,
+  work_view& node_flux,
+  work_view& node_mass_post,
+  work_view& node_mass_pre,
+  work_view& post_vol) {
+
+  const int dj = (dir == g_xdir) ? 1 : 0;
+  const int dk = 1-dj;
+
+  const std::string name = (dir == g_xdir) ? "advec_mom dir1" : "advec_mom dir2";
+
+  // DO k=y_min-2*dk,y_max+1+dk
+  //   DO j=x_min-2*dj,x_max+1+dj
+  Kokkos::parallel_for(name + " node_flux",
+    field_policy(space, {x_min-2*dj+1, y_min-2*dk+1}, {x_max+1+dj+2, y_max+1+dk+2}),
+    KOKKOS_LAMBDA (const int j, const int k) {
+      // Find staggered mesh mass fluxes, nodal masses and volumes.
+      node_flux(j,k)=0.25*(mass_flux(j-dk,k-dj)+mass_flux(j  ,k  )
+        +mass_flux(j+dj-dk,k+dk-dj)+mass_flux(j+dj,k+dk));
+    });
+
+  // DO k=y_min-dk,y_max+1+dk
+  //   DO j=x_min-dj,x_max+1+dj
+  Kokkos::parallel_for(name + " node_mass_pre",
+    field_policy(space, {x_min-dj+1, y_min-dk+1}, {x_max+1+dj+2, y_max+1+dk+2}),
+    KOKKOS_LAMBDA (const int j, const int k) {
+      // Staggered cell mass post advection
+      if (fused) {
+        node_mass_post(j,k)=0.25*(density1(j  ,k-1)*advec_mom_post_vol<dir,sweep_number>(j  ,k-1, volume, vol_flux_across)
+          +density1(j  ,k  )*advec_mom_post_vol<dir,sweep_number>(j  ,k  , volume, vol_flux_across)
+          +density1(j-1,k-1)*advec_mom_post_vol<dir,sweep_number>(j-1,k-1, volume, vol_flux_across)
+          +density1(j-1,k  )*advec_mom_post_vol<dir,sweep_number>(j-1,k  , volume, vol_flux_across));
+      }
+      else {
+        node_mass_post(j,k)=0.25*(density1(j  ,k-1)*post_vol(j  ,k-1)
+          +density1(j  ,k  )*post_vol(j  ,k  )
+          +density1(j-1,k-1)*post_vol(j-1,k-1)
+          +density1(j-1,k  )*post_vol(j-1,k  ));
+      }
+      node_mass_pre(j,k)=node_mass_post(j,k)-node_flux(j-dj,k-dk)+node_flux(j,k);
+    });
+}
 
 //  @brief Fortran momentum advection kernel
 //  @author Wayne Gaudin
 //  @details Performs a second order advective remap on the vertex momentum
-//  using van-Leer limiting and directional splitting.
+//  using van-Leer limiting and directional splitting. The direction and sweep
+//  are template parameters, so one implementation serves both directions with
+//  the index offsets known at compile time.
 //  Note that although pre_vol is only set and not used in the update, please
 //  leave it in the method.
+template <int dir, int sweep_number>
 void advec_mom_kernel(
+  const exec_space& space,
   int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& vel1,
-  Kokkos::View<double**>& mass_flux_x,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& mass_flux_y,
-  Kokkos::View<double**>& vol_flux_y,
-  Kokkos::View<double**>& volume,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& node_flux,
-  Kokkos::View<double**>& node_mass_post,
-  Kokkos::View<double**>& node_mass_pre,
-  Kokkos::View<double**>& mom_flux,
-  Kokkos::View<double**>& pre_vol,
-  Kokkos::View<double**>& post_vol,
-  Kokkos::View<double*>& celldx,
-  Kokkos::View<double*>& celldy,
-  int which_vel,
-  int sweep_number,
-  int direction) {
-
-  int mom_sweep=direction+2*(sweep_number-1);
+  field_view& vel1,
+  field_view& mass_flux,
+  field_view& vol_flux,
+  field_view& vol_flux_across,
+  field_view& volume,
+  field_view& density1,
+  work_view& node_flux,
+  work_view& node_mass_post,
+  work_view& node_mass_pre,
+  work_view& mom_flux,
+  work_view& pre_vol,
+  work_view& post_vol,
+  Kokkos::View<double*>& celld,
+  int which_vel) {
+
+  const int dj = (dir == g_xdir) ? 1 : 0;
+  const int dk = 1-dj;
+
+  const std::string name = (dir == g_xdir) ? "advec_mom dir1" : "advec_mom dir2";
 
   // DO k=y_min-2,y_max+2
   //   DO j=x_min-2,x_max+2
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min-2+1, y_min-2+1}, {x_max+2+2, y_max+2+2});
+  field_policy policy(space, {x_min-2+1, y_min-2+1}, {x_max+2+2, y_max+2+2});
+  Kokkos::parallel_for(name + " post_vol", policy, KOKKOS_LAMBDA(const int j, const int k) {
+      const int i = (dir == g_xdir) ? j : k;
+      post_vol(j,k)=advec_mom_post_vol<dir,sweep_number>(j, k, volume, vol_flux_across);
+      if (sweep_number == 1) {
+        pre_vol(j,k)=post_vol(j,k)+advec_along<dir>(vol_flux,j,k,i+1)-vol_flux(j,k);
+      }
+      else {
+        const int across = (dir == g_xdir) ? g_ydir : g_xdir;
+        const int c = (dir == g_xdir) ? k : j;
+        pre_vol(j,k)=post_vol(j,k)+advec_along<across>(vol_flux_across,j,k,c+1)-vol_flux_across(j,k);
+      }
+  });
 
-  if (mom_sweep == 1) { // x 1
-    Kokkos::parallel_for("advec_mom x1", policy, KOKKOS_LAMBDA(const int j, const int k) {
-        post_vol(j,k)= volume(j,k)+vol_flux_y(j  ,k+1)-vol_flux_y(j,k);
-        pre_vol(j,k)=post_vol(j,k)+vol_flux_x(j+1,k  )-vol_flux_x(j,k);
-    });
+  if (which_vel == 1) {
+    advec_mom_node<dir, sweep_number, false>(space, x_min, x_max, y_min, y_max,
+      mass_flux, vol_flux_across, volume, density1,
+      node_flux, node_mass_post, node_mass_pre, post_vol);
   }
-  else if (mom_sweep == 2) { // y 1
-    Kokkos::parallel_for("advec_mom y1", policy, KOKKOS_LAMBDA(const int j, const int k) {
-        post_vol(j,k)= volume(j,k)+vol_flux_x(j+1,k  )-vol_flux_x(j,k);
-        pre_vol(j,k)=post_vol(j,k)+vol_flux_y(j  ,k+1)-vol_flux_y(j,k);
+
+  // DO k=y_min-dk,y_max+1
+  //  DO j=x_min-dj,x_max+1
+  Kokkos::parallel_for(name + " mom_flux",
+    field_policy(space, {x_min-dj+1, y_min-dk+1}, {x_max+1+2, y_max+1+2}),
+    KOKKOS_LAMBDA (const int j, const int k) {
+      mom_flux(j,k)=advec_mom_flux<dir>(j, k, vel1, node_flux, node_mass_pre, celld);
     });
-  }
-  else if (mom_sweep == 3) { // x 2
-    Kokkos::parallel_for("advec_mom x1", policy, KOKKOS_LAMBDA(const int j, const int k) {
-        post_vol(j,k)=volume(j,k);
-        pre_vol(j,k)=post_vol(j,k)+vol_flux_y(j  ,k+1)-vol_flux_y(j,k);
+
+  // DO k=y_min,y_max+1
+  //   DO j=x_min,x_max+1
+  Kokkos::parallel_for(name + " vel1",
+    field_policy(space, {x_min+1, y_min+1}, {x_max+1+2, y_max+1+2}),
+    KOKKOS_LAMBDA (const int j, const int k) {
+      vel1(j,k)=(vel1(j,k)*node_mass_pre(j,k)+mom_flux(j-dj,k-dk)-mom_flux(j,k))/node_mass_post(j,k);
     });
-  }
-  else if (mom_sweep ==  4) { // y 2
-    Kokkos::parallel_for("advec_mom y1", policy, KOKKOS_LAMBDA(const int j, const int k) {
-        post_vol(j,k)=volume(j,k);
-        pre_vol(j,k)=post_vol(j,k)+vol_flux_x(j+1,k  )-vol_flux_x(j,k);
+}
+
+//  @brief Fused momentum advection kernel
+//  @details Advects both velocity components in one call. The node flux and
+//  node masses are built once, with post_vol computed on the fly rather than
+//  stored, and the momentum fluxes and velocity updates of both components
+//  share their passes. Gives results identical to two calls of
+//  advec_mom_kernel.
+template <int dir, int sweep_number>
+void advec_mom_fused_kernel(
+  const exec_space& space,
+  int x_min, int x_max, int y_min, int y_max,
+  field_view& xvel1,
+  field_view& yvel1,
+  field_view& mass_flux,
+  field_view& vol_flux_across,
+  field_view& volume,
+  field_view& density1,
+  work_view& node_flux,
+  work_view& node_mass_post,
+  work_view& node_mass_pre,
+  work_view& xmom_flux,
+  work_view& ymom_flux,
+  Kokkos::View<double*>& celld) {
+
+  const int dj = (dir == g_xdir) ? 1 : 0;
+  const int dk = 1-dj;
+
+  const std::string name = (dir == g_xdir) ? "advec_mom fused dir1" : "advec_mom fused dir2";
+
+  // No post_vol work array is needed when fused
+  advec_mom_node<dir, sweep_number, true>(space, x_min, x_max, y_min, y_max,
+    mass_flux, vol_flux_across, volume, density1,
+    node_flux, node_mass_post, node_mass_pre, node_flux);
+
+  // DO k=y_min-dk,y_max+1
+  //  DO j=x_min-dj,x_max+1
+  Kokkos::parallel_for(name + " mom_flux",
+    field_policy(space, {x_min-dj+1, y_min-dk+1}, {x_max+1+2, y_max+1+2}),
+    KOKKOS_LAMBDA (const int j, const int k) {
+      xmom_flux(j,k)=advec_mom_flux<dir>(j, k, xvel1, node_flux, node_mass_pre, celld);
+      ymom_flux(j,k)=advec_mom_flux<dir>(j, k, yvel1, node_flux, node_mass_pre, celld);
     });
-  }
 
-  if (direction == 1) {
-    if (which_vel == 1) {
-      // DO k=y_min,y_max+1
-      //   DO j=x_min-2,x_max+2
-      Kokkos::parallel_for("advec_mom dir1, vel1, node_flux",
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min-2+1, y_min+1}, {x_max+2+2, y_max+1+2}),
-        KOKKOS_LAMBDA (const int j, const int k) {
-          // Find staggered mesh mass fluxes, nodal masses and volumes.
-          node_flux(j,k)=0.25*(mass_flux_x(j,k-1  )+mass_flux_x(j  ,k)
-            +mass_flux_x(j+1,k-1)+mass_flux_x(j+1,k));
-        });
-
-      // DO k=y_min,y_max+1
-      //   DO j=x_min-1,x_max+2
-      Kokkos::parallel_for("advec_mom dir1, vel1, node_mass_pre",
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min-1+1, y_min+1}, {x_max+2+2, y_max+1+2}),
-        KOKKOS_LAMBDA (const int j, const int k) {
-          // Staggered cell mass post advection
-          node_mass_post(j,k)=0.25*(density1(j  ,k-1)*post_vol(j  ,k-1)
-            +density1(j  ,k  )*post_vol(j  ,k  )
-            +density1(j-1,k-1)*post_vol(j-1,k-1)
-            +density1(j-1,k  )*post_vol(j-1,k  ));
-          node_mass_pre(j,k)=node_mass_post(j,k)-node_flux(j-1,k)+node_flux(j,k);
-        });
-    }
-
-    // DO k=y_min,y_max+1
-    //  DO j=x_min-1,x_max+1
-    Kokkos::parallel_for("advec_mom dir1, mom_flux",
-      Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min-1+1, y_min+1}, {x_max+1+2, y_max+1+2}),
-      KOKKOS_LAMBDA (const int j, const int k) {
-
-        int upwind, donor, downwind, dif;
-        double sigma, width, limiter, vdiffuw, vdiffdw, auw, adw, wind, advec_vel_s;
-
-        if (node_flux(j,k) < 0.0) {
-          upwind=j+2;
-          donor=j+1;
-          downwind=j;
-          dif=donor;
-        }
-        else {
-          upwind=j-1;
-          donor=j;
-          downwind=j+1;
-          dif=upwind;
-        }
-
-        sigma=fabs(node_flux(j,k))/(node_mass_pre(donor,k));
-        width=celldx(j);
-        vdiffuw=vel1(donor,k)-vel1(upwind,k);
-        vdiffdw=vel1(downwind,k)-vel1(donor,k);
-        limiter=0.0;
-        if (vdiffuw*vdiffdw > 0.0) {
-          auw=fabs(vdiffuw);
-          adw=fabs(vdiffdw);
-          wind=1.0;
-          if (vdiffdw <= 0.0) wind=-1.0;
-          limiter=wind*MIN(MIN(width*((2.0-sigma)*adw/width+(1.0+sigma)*auw/celldx(dif))/6.0,auw),adw);
-        }
-        advec_vel_s=vel1(donor,k)+(1.0-sigma)*limiter;
-        mom_flux(j,k)=advec_vel_s*node_flux(j,k);
-      });
-
-    // DO k=y_min,y_max+1
-    //   DO j=x_min,x_max+1
-    Kokkos::parallel_for("advec_mom dir1, vel1",
-      Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min+1, y_min+1}, {x_max+1+2, y_max+1+2}),
-      KOKKOS_LAMBDA (const int j, const int k) {
-        vel1 (j,k)=(vel1 (j,k)*node_mass_pre(j,k)+mom_flux(j-1,k)-mom_flux(j,k))/node_mass_post(j,k);
-      });
-  }
-  else if (direction == 2) {
-    if (which_vel == 1) {
-      // DO k=y_min-2,y_max+2
-      //   DO j=x_min,x_max+1
-      Kokkos::parallel_for("advec_mom dir2, vel1, node_flux",
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min+1, y_min-2+1}, {x_max+1+2, y_max+2+2}),
-        KOKKOS_LAMBDA (const int j, const int k) {
-          // Find staggered mesh mass fluxes and nodal masses and volumes.
-          node_flux(j,k)=0.25*(mass_flux_y(j-1,k  )+mass_flux_y(j  ,k  )
-            +mass_flux_y(j-1,k+1)+mass_flux_y(j  ,k+1));
-        });
-
-
-      // DO k=y_min-1,y_max+2
-      //   DO j=x_min,x_max+1
-      Kokkos::parallel_for("advec_mom dir2, vel1, node_mass_pre",
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min+1, y_min-1+1}, {x_max+1+2, y_max+2+2}),
-        KOKKOS_LAMBDA (const int j, const int k) {
-          node_mass_post(j,k)=0.25*(density1(j  ,k-1)*post_vol(j  ,k-1)
-            +density1(j  ,k  )*post_vol(j  ,k  )
-            +density1(j-1,k-1)*post_vol(j-1,k-1)
-            +density1(j-1,k  )*post_vol(j-1,k  ));
-          node_mass_pre(j,k)=node_mass_post(j,k)-node_flux(j,k-1)+node_flux(j,k);
-        });
-    }
-
-    // DO k=y_min-1,y_max+1
-    //   DO j=x_min,x_max+1
-    Kokkos::parallel_for("advec_mom dir2, mom_flux",
-      Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min+1, y_min-1+1}, {x_max+1+2, y_max+1+2}),
-      KOKKOS_LAMBDA (const int j, const int k) {
-
-        int upwind, donor, downwind, dif;
-        double sigma, width, limiter, vdiffuw, vdiffdw, auw, adw, wind, advec_vel_s;
-
-        if (node_flux(j,k) < 0.0) {
-          upwind=k+2;
-          donor=k+1;
-          downwind=k;
-          dif=donor;
-        }
-        else {
-          upwind=k-1;
-          donor=k;
-          downwind=k+1;
-          dif=upwind;
-        }
-
-        sigma=fabs(node_flux(j,k))/(node_mass_pre(j,donor));
-        width=celldy(k);
-        vdiffuw=vel1(j,donor)-vel1(j,upwind);
-        vdiffdw=vel1(j,downwind)-vel1(j,donor);
-        limiter=0.0;
-        if (vdiffuw*vdiffdw > 0.0) {
-          auw=fabs(vdiffuw);
-          adw=fabs(vdiffdw);
-          wind=1.0;
-          if (vdiffdw <= 0.0) wind=-1.0;
-          limiter=wind*MIN(MIN(width*((2.0-sigma)*adw/width+(1.0+sigma)*auw/celldy(dif))/6.0,auw),adw);
-        }
-        advec_vel_s=vel1(j,donor)+(1.0-sigma)*limiter;
-        mom_flux(j,k)=advec_vel_s*node_flux(j,k);
-      });
-
-
-    // DO k=y_min,y_max+1
-    //   DO j=x_min,x_max+1
-    Kokkos::parallel_for("advec_mom dir2, vel1",
-      Kokkos::MDRangePolicy<Kokkos::Rank<2>>({x_min+1, y_min+1}, {x_max+1+2, y_max+1+2}),
-      KOKKOS_LAMBDA (const int j, const int k) {
-        vel1 (j,k)=(vel1(j,k)*node_mass_pre(j,k)+mom_flux(j,k-1)-mom_flux(j,k))/node_mass_post(j,k);
-      });
-  }
+  // DO k=y_min,y_max+1
+  //   DO j=x_min,x_max+1
+  Kokkos::parallel_for(name + " vel1",
+    field_policy(space, {x_min+1, y_min+1}, {x_max+1+2, y_max+1+2}),
+    KOKKOS_LAMBDA (const int j, const int k) {
+      xvel1(j,k)=(xvel1(j,k)*node_mass_pre(j,k)+xmom_flux(j-dj,k-dk)-xmom_flux(j,k))/node_mass_post(j,k);
+      yvel1(j,k)=(yvel1(j,k)*node_mass_pre(j,k)+ymom_flux(j-dj,k-dk)-ymom_flux(j,k))/node_mass_post(j,k);
+    });
+}
+
+
+//  @brief Momentum advection for one direction and sweep
+//  @details Passes the fields along the sweep to the kernel.
+template <int dir, int sweep_number>
+void advec_mom_tile(global_variables& globals, int tile, int which_vel, int ring) {
+
+  field_type& field = globals.tiles[tile].field;
+
+  int x_min, x_max, y_min, y_max;
+  redundant_bounds(globals, tile, ring, x_min, x_max, y_min, y_max);
+
+  advec_mom_kernel<dir, sweep_number>(
+    globals.tiles[tile].space,
+    x_min,
+    x_max,
+    y_min,
+    y_max,
+    (which_vel == 1) ? field.xvel1 : field.yvel1,
+    (dir == g_xdir) ? field.mass_flux_x : field.mass_flux_y,
+    (dir == g_xdir) ? field.vol_flux_x : field.vol_flux_y,
+    (dir == g_xdir) ? field.vol_flux_y : field.vol_flux_x,
+    field.volume,
+    field.density1,
+    scratch(globals, tile, scratch_node_flux),
+    scratch(globals, tile, scratch_node_mass_post),
+    scratch(globals, tile, scratch_node_mass_pre),
+    scratch(globals, tile, scratch_mom_flux),
+    scratch(globals, tile, scratch_mom_pre_vol),
+    scratch(globals, tile, scratch_mom_post_vol),
+    (dir == g_xdir) ? field.celldx : field.celldy,
+    which_vel);
+}
+
+//  @brief Fused momentum advection for one direction and sweep
+//  @details Passes the fields along the sweep to the fused kernel.
+template <int dir, int sweep_number>
+void advec_mom_fused_tile(global_variables& globals, int tile, int ring) {
+
+  field_type& field = globals.tiles[tile].field;
+
+  int x_min, x_max, y_min, y_max;
+  redundant_bounds(globals, tile, ring, x_min, x_max, y_min, y_max);
+
+  advec_mom_fused_kernel<dir, sweep_number>(
+    globals.tiles[tile].space,
+    x_min,
+    x_max,
+    y_min,
+    y_max,
+    field.xvel1,
+    field.yvel1,
+    (dir == g_xdir) ? field.mass_flux_x : field.mass_flux_y,
+    (dir == g_xdir) ? field.vol_flux_y : field.vol_flux_x,
+    field.volume,
+    field.density1,
+    scratch(globals, tile, scratch_node_flux),
+    scratch(globals, tile, scratch_node_mass_post),
+    scratch(globals, tile, scratch_node_mass_pre),
+    scratch(globals, tile, scratch_mom_flux),
+    scratch(globals, tile, scratch_ymom_flux),
+    (dir == g_xdir) ? field.celldx : field.celldy);
 }
 
 
 //  @brief Momentum advection driver
 //  @author Wayne Gaudin
-//  @details Invokes the user specified momentum advection kernel.
-void advec_mom_driver(global_variables& globals, int tile, int which_vel, int direction, int sweep_number) {
+//  @details Invokes the user specified momentum advection kernel, specialised
+//  for the direction and sweep, over the tile grown by ring cells.
+void advec_mom_driver(global_variables& globals, int tile, int which_vel, int direction, int sweep_number, int ring) {
 
-  if (which_vel == 1) {
-    advec_mom_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.tiles[tile].field.volume,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.tiles[tile].field.work_array1,
-      globals.chunk.tiles[tile].field.work_array2,
-      globals.chunk.tiles[tile].field.work_array3,
-      globals.chunk.tiles[tile].field.work_array4,
-      globals.chunk.tiles[tile].field.work_array5,
-      globals.chunk.tiles[tile].field.work_array6,
-      globals.chunk.tiles[tile].field.celldx,
-      globals.chunk.tiles[tile].field.celldy,
-      which_vel,
-      sweep_number,
-      direction);
+  if (direction == g_xdir) {
+    if (sweep_number == 1) advec_mom_tile<g_xdir, 1>(globals, tile, which_vel, ring);
+    else                   advec_mom_tile<g_xdir, 2>(globals, tile, which_vel, ring);
   }
-  else {
-    advec_mom_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.tiles[tile].field.volume,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.tiles[tile].field.work_array1,
-      globals.chunk.tiles[tile].field.work_array2,
-      globals.chunk.tiles[tile].field.work_array3,
-      globals.chunk.tiles[tile].field.work_array4,
-      globals.chunk.tiles[tile].field.work_array5,
-      globals.chunk.tiles[tile].field.work_array6,
-      globals.chunk.tiles[tile].field.celldx,
-      globals.chunk.tiles[tile].field.celldy,
-      which_vel,
-      sweep_number,
-      direction);
+  else if (direction == g_ydir) {
+    if (sweep_number == 1) advec_mom_tile<g_ydir, 1>(globals, tile, which_vel, ring);
+    else                   advec_mom_tile<g_ydir, 2>(globals, tile, which_vel, ring);
   }
 
 }
 
+//  @brief Fused momentum advection driver
+//  @details Advects both velocity components of a tile with the fused kernel.
+void advec_mom_fused_driver(global_variables& globals, int tile, int direction, int sweep_number, int ring) {
+
+  if (direction == g_xdir) {
+    if (sweep_number == 1) advec_mom_fused_tile<g_xdir, 1>(globals, tile, ring);
+    else                   advec_mom_fused_tile<g_xdir, 2>(globals, tile, ring);
+  }
+  else if (direction == g_ydir) {
+    if (sweep_number == 1) advec_mom_fused_tile<g_ydir, 1>(globals, tile, ring);
+    else                   advec_mom_fused_tile<g_ydir, 2>(globals, tile, ring);
+  }
+
+}
 
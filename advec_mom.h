@@ -23,7 +23,8 @@
 
 #include "definitions.h"
 
-void advec_mom_driver(global_variables& globals, int tile, int which_vel, int direction, int sweep_number);
+void advec_mom_driver(global_variables& globals, int tile, int which_vel, int direction, int sweep_number, int ring);
+void advec_mom_fused_driver(global_variables& globals, int tile, int direction, int sweep_number, int ring);
 
 #endif
 
@@ -20,7 +20,7 @@
 
 #include "advection.h"
 #include "update_halo.h"
-#include "timer.h"
+#include "profiler.h"
 #include "advec_cell.h"
 #include "advec_mom.h"
 
@@ -43,15 +43,51 @@ void advection(global_variables& globals) {
   fields[field_density1] = 1;
   fields[field_vol_flux_x] = 1;
   fields[field_vol_flux_y] = 1;
-  update_halo(globals, fields,2);
-
   double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
-  for (int tile=0; tile < globals.tiles_per_chunk; ++tile) {
-    advec_cell_driver(globals, tile, sweep_number, direction);
+  if (globals.halo_depth >= 4) {
+    // With a halo four cells deep the first sweep also runs over two cells
+    // of the halo, which is as far as the momentum advection reads, so the
+    // exchange after it is replaced by the reflective update. The velocities
+    // come along in this exchange instead.
+    fields[field_xvel1] = 1;
+    fields[field_yvel1] = 1;
+    update_halo(globals, fields, 4);
+
+    kernel_time = profiler_start(globals, "cell_advection");
+    for (int tile=0; tile < globals.local_tiles; ++tile) {
+      advec_cell_driver(globals, tile, sweep_number, direction, overlap_all, 2);
+    }
+    profiler_stop(globals, globals.profiler.cell_advection, kernel_time);
+  }
+  else if (globals.overlap_halo) {
+    // The volumes and the fluxes that read no halo cells are computed while
+    // the exchange is in flight
+    update_halo_start(globals, fields, 2);
+
+    kernel_time = profiler_start(globals, "cell_advection");
+    for (int tile=0; tile < globals.local_tiles; ++tile) {
+      advec_cell_driver(globals, tile, sweep_number, direction, overlap_interior, 0);
+    }
+    profiler_stop(globals, globals.profiler.cell_advection, kernel_time);
+
+    update_halo_finish(globals, fields, 2);
+
+    kernel_time = profiler_start(globals, "cell_advection");
+    for (int tile=0; tile < globals.local_tiles; ++tile) {
+      advec_cell_driver(globals, tile, sweep_number, direction, overlap_boundary, 0);
+    }
+    profiler_stop(globals, globals.profiler.cell_advection, kernel_time);
   }
+  else {
+    update_halo(globals, fields,2);
 
-  if (globals.profiler_on) globals.profiler.cell_advection += timer()-kernel_time;
+    kernel_time = profiler_start(globals, "cell_advection");
+    for (int tile=0; tile < globals.local_tiles; ++tile) {
+      advec_cell_driver(globals, tile, sweep_number, direction, overlap_all, 0);
+    }
+
+    profiler_stop(globals, globals.profiler.cell_advection, kernel_time);
+  }
 
   for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
   fields[field_density1] = 1;
@@ -60,29 +96,39 @@ void advection(global_variables& globals) {
   fields[field_yvel1] = 1;
   fields[field_mass_flux_x] = 1;
   fields[field_mass_flux_y] = 1;
-  update_halo(globals, fields, 2);
+  if (globals.halo_depth >= 4) {
+    update_halo_reflect(globals, fields, 2);
+  }
+  else {
+    update_halo(globals, fields, 2);
+  }
 
-  if (globals.profiler_on) kernel_time=timer();
+  kernel_time = profiler_start(globals, "mom_advection");
 
 
-  for (int tile=0; tile < globals.tiles_per_chunk; ++tile) {
-    advec_mom_driver(globals, tile, xvel, direction, sweep_number);
-    advec_mom_driver(globals, tile, yvel, direction, sweep_number);
+  for (int tile=0; tile < globals.local_tiles; ++tile) {
+    if (globals.fused_advec_mom) {
+      advec_mom_fused_driver(globals, tile, direction, sweep_number, 0);
+    }
+    else {
+      advec_mom_driver(globals, tile, xvel, direction, sweep_number, 0);
+      advec_mom_driver(globals, tile, yvel, direction, sweep_number, 0);
+    }
   }
 
-  if (globals.profiler_on) globals.profiler.mom_advection += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.mom_advection, kernel_time);
 
   sweep_number=2;
   if (globals.advect_x)  direction = g_ydir;
   if (!globals.advect_x) direction = g_xdir;
 
-  if (globals.profiler_on) kernel_time=timer();
+  kernel_time = profiler_start(globals, "cell_advection");
 
-  for (int tile=0; tile < globals.tiles_per_chunk; ++tile) {
-    advec_cell_driver(globals, tile, sweep_number, direction);
+  for (int tile=0; tile < globals.local_tiles; ++tile) {
+    advec_cell_driver(globals, tile, sweep_number, direction, overlap_all, 0);
   }
 
-  if (globals.profiler_on) globals.profiler.cell_advection += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.cell_advection, kernel_time);
 
   for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
   fields[field_density1] = 1;
@@ -93,14 +139,19 @@ void advection(global_variables& globals) {
   fields[field_mass_flux_y] = 1;
   update_halo(globals, fields, 2);
 
-  if (globals.profiler_on) kernel_time=timer();
+  kernel_time = profiler_start(globals, "mom_advection");
 
-  for (int tile=0; tile < globals.tiles_per_chunk; ++tile) {
-    advec_mom_driver(globals, tile, xvel, direction, sweep_number);
-    advec_mom_driver(globals, tile, yvel, direction, sweep_number);
+  for (int tile=0; tile < globals.local_tiles; ++tile) {
+    if (globals.fused_advec_mom) {
+      advec_mom_fused_driver(globals, tile, direction, sweep_number, 0);
+    }
+    else {
+      advec_mom_driver(globals, tile, xvel, direction, sweep_number, 0);
+      advec_mom_driver(globals, tile, yvel, direction, sweep_number, 0);
+    }
   }
 
-  if (globals.profiler_on) globals.profiler.mom_advection += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.mom_advection, kernel_time);
 
 }
 
@@ -0,0 +1,371 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+//  @brief Load balancing of the chunk decomposition
+//  @details Every balance_frequency steps each task reports the compute time
+//  it has spent since the last balance. If the slowest task is more than
+//  balance_tolerance above the mean, the column and row boundaries of the
+//  chunk grid are moved so that every column, and every row, holds the same
+//  share of the measured cost, taking the cost of a chunk as spread evenly
+//  over its cells. Each chunk keeps its place in the grid, so its neighbours
+//  and the halo communicators are unchanged. Only the state carried from one
+//  step to the next moves between tasks: the density, energy and velocities.
+//  The fields and buffers are then rebuilt for the new extents, the mesh
+//  regenerated and the halos primed as at the start.
+
+#include "balance.h"
+#include "build_field.h"
+#include "ideal_gas.h"
+#include "initialise_chunk.h"
+#include "profiler.h"
+#include "update_halo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+extern std::ostream g_out;
+
+namespace {
+
+// Compute time of the task at the last balance
+double balanced_compute_time = 0.0;
+
+// Box of global indices, cells numbered from 1 and nodes from 0
+struct index_box {
+  int j_min, j_max, k_min, k_max;
+
+  int size() const {
+    return (j_max < j_min || k_max < k_min) ? 0 : (j_max-j_min+1)*(k_max-k_min+1);
+  }
+};
+
+struct chunk_extent {
+  int left, right, bottom, top;
+};
+
+// The state fields that move with the cells, and whether each is on nodes
+const int num_balance_fields = 4;
+const bool balance_field_nodes[num_balance_fields] = {false, false, true, true};
+
+field_view& balance_field(field_type& field, int f) {
+
+  switch (f) {
+    case 0: return field.density0;
+    case 1: return field.energy0;
+    case 2: return field.xvel0;
+  }
+  return field.yvel0;
+}
+
+// The cells or nodes a chunk holds. The nodes on the boundary between two
+// chunks are held by both.
+index_box held_box(const chunk_extent& e, bool nodes) {
+
+  if (nodes) return {e.left-1, e.right, e.bottom-1, e.top};
+  return {e.left, e.right, e.bottom, e.top};
+}
+
+// The cells or nodes a chunk sends on, so each one comes from a single chunk.
+// The nodes on the left and bottom of a chunk are its neighbour's, unless
+// they are on the edge of the mesh.
+index_box owned_box(const chunk_extent& e, bool nodes) {
+
+  if (nodes) return {e.left == 1 ? 0 : e.left, e.right, e.bottom == 1 ? 0 : e.bottom, e.top};
+  return {e.left, e.right, e.bottom, e.top};
+}
+
+index_box intersect(const index_box& a, const index_box& b) {
+
+  return {std::max(a.j_min, b.j_min), std::min(a.j_max, b.j_max),
+    std::max(a.k_min, b.k_min), std::min(a.k_max, b.k_max)};
+}
+
+// Boundaries of a row of parts holding equal shares of the cost, the cost of
+// each current part spread evenly over its cells. No part is made narrower
+// than min_width.
+std::vector<int> balance_cuts(const std::vector<int>& bounds, const std::vector<double>& costs, const int min_width) {
+
+  const int parts = costs.size();
+
+  double total = 0.0;
+  for (int p = 0; p < parts; ++p) total += costs[p];
+
+  std::vector<int> cuts(parts+1);
+  cuts[0] = bounds[0];
+  cuts[parts] = bounds[parts];
+
+  int p = 0;
+  double below = 0.0; // Cost before bounds[p]
+  for (int c = 1; c < parts; ++c) {
+    const double target = total*c/parts;
+    while (p < parts-1 && below+costs[p] < target) {
+      below += costs[p];
+      ++p;
+    }
+    double x = bounds[p];
+    if (costs[p] > 0.0) x += (target-below)/costs[p]*(bounds[p+1]-bounds[p]);
+
+    int cut = (int)std::lround(x);
+    cut = std::max(cut, cuts[c-1]+min_width);
+    cut = std::min(cut, bounds[parts]-(parts-c)*min_width);
+    cuts[c] = cut;
+  }
+
+  return cuts;
+}
+
+// Copies the state of every tile into one host array per field covering the
+// cells or nodes the chunk holds
+void gather_state(global_variables& globals, const chunk_extent& e, std::vector<double> state[]) {
+
+  for (int f = 0; f < num_balance_fields; ++f) {
+    const bool nodes = balance_field_nodes[f];
+    const index_box chunk_box = held_box(e, nodes);
+    const int width = chunk_box.j_max-chunk_box.j_min+1;
+    state[f].resize(chunk_box.size());
+
+    for (int tile = 0; tile < globals.local_tiles; ++tile) {
+      tile_type& t = globals.tiles[tile];
+      field_view& view = balance_field(t.field, f);
+      typename field_view::HostMirror hm_view = Kokkos::create_mirror_view(view);
+      Kokkos::deep_copy(hm_view, view);
+
+      const index_box tile_box = held_box({t.t_left, t.t_right, t.t_bottom, t.t_top}, nodes);
+      const int offset = nodes ? 1 : 0;
+      for (int k = tile_box.k_min; k <= tile_box.k_max; ++k) {
+        for (int j = tile_box.j_min; j <= tile_box.j_max; ++j) {
+          state[f][(k-chunk_box.k_min)*width+j-chunk_box.j_min] =
+            hm_view(t.t_xmin+1+offset+j-t.t_left, t.t_ymin+1+offset+k-t.t_bottom);
+        }
+      }
+    }
+  }
+}
+
+// Copies the host arrays of the chunk state into the tiles
+void scatter_state(global_variables& globals, const chunk_extent& e, std::vector<double> state[]) {
+
+  for (int f = 0; f < num_balance_fields; ++f) {
+    const bool nodes = balance_field_nodes[f];
+    const index_box chunk_box = held_box(e, nodes);
+    const int width = chunk_box.j_max-chunk_box.j_min+1;
+
+    for (int tile = 0; tile < globals.local_tiles; ++tile) {
+      tile_type& t = globals.tiles[tile];
+      field_view& view = balance_field(t.field, f);
+      typename field_view::HostMirror hm_view = Kokkos::create_mirror_view(view);
+      Kokkos::deep_copy(hm_view, view);
+
+      const index_box tile_box = held_box({t.t_left, t.t_right, t.t_bottom, t.t_top}, nodes);
+      const int offset = nodes ? 1 : 0;
+      for (int k = tile_box.k_min; k <= tile_box.k_max; ++k) {
+        for (int j = tile_box.j_min; j <= tile_box.j_max; ++j) {
+          hm_view(t.t_xmin+1+offset+j-t.t_left, t.t_ymin+1+offset+k-t.t_bottom) =
+            state[f][(k-chunk_box.k_min)*width+j-chunk_box.j_min];
+        }
+      }
+      Kokkos::deep_copy(view, hm_view);
+    }
+  }
+}
+
+// Copies a box of a chunk state array to or from a message
+void copy_box(std::vector<double>& state, const index_box& chunk_box, const index_box& box, double *message, bool pack) {
+
+  const int width = chunk_box.j_max-chunk_box.j_min+1;
+  int index = 0;
+  for (int k = box.k_min; k <= box.k_max; ++k) {
+    for (int j = box.j_min; j <= box.j_max; ++j) {
+      double& value = state[(k-chunk_box.k_min)*width+j-chunk_box.j_min];
+      if (pack) message[index] = value;
+      else value = message[index];
+      ++index;
+    }
+  }
+}
+}
+
+void balance(global_variables& globals, parallel_& parallel) {
+
+  // Balancing needs one chunk per task, which read_input checks
+  chunk_type& chunk = globals.chunks[0];
+  const int tasks = parallel.max_task;
+
+  const double compute_time = profiler_compute_time(globals);
+  double report[5] = {(double)chunk.left, (double)chunk.right, (double)chunk.bottom, (double)chunk.top,
+    compute_time-balanced_compute_time};
+  balanced_compute_time = compute_time;
+
+  std::vector<double> reports(5*tasks);
+  clover_allgather(report, 5, reports.data());
+
+  std::vector<chunk_extent> old_extent(tasks);
+  std::vector<double> cost(tasks);
+  double mean = 0.0, maximum = 0.0;
+  for (int task = 0; task < tasks; ++task) {
+    const double *r = &reports[5*task];
+    old_extent[task] = {(int)r[0], (int)r[1], (int)r[2], (int)r[3]};
+    cost[task] = r[4];
+    mean += cost[task]/tasks;
+    maximum = std::max(maximum, cost[task]);
+  }
+  if (mean <= 0.0 || maximum <= (1.0+globals.balance_tolerance)*mean) return;
+
+  // The grid of chunks, from where its columns and rows start
+  std::vector<int> columns, rows;
+  for (int task = 0; task < tasks; ++task) {
+    columns.push_back(old_extent[task].left);
+    rows.push_back(old_extent[task].bottom);
+  }
+  std::sort(columns.begin(), columns.end());
+  columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  columns.push_back(globals.grid.x_cells+1);
+  rows.push_back(globals.grid.y_cells+1);
+
+  const int chunk_x = columns.size()-1;
+  const int chunk_y = rows.size()-1;
+  std::vector<int> task_column(tasks), task_row(tasks);
+  std::vector<double> column_cost(chunk_x, 0.0), row_cost(chunk_y, 0.0);
+  for (int task = 0; task < tasks; ++task) {
+    task_column[task] = std::lower_bound(columns.begin(), columns.end(), old_extent[task].left)-columns.begin();
+    task_row[task] = std::lower_bound(rows.begin(), rows.end(), old_extent[task].bottom)-rows.begin();
+    column_cost[task_column[task]] += cost[task];
+    row_cost[task_row[task]] += cost[task];
+  }
+
+  // Every tile has to stay at least as wide as the halo
+  const int min_width = globals.halo_depth*globals.tiles_per_chunk;
+  std::vector<int> new_columns = balance_cuts(columns, column_cost, std::min(min_width, globals.grid.x_cells/chunk_x));
+  std::vector<int> new_rows = balance_cuts(rows, row_cost, std::min(min_width, globals.grid.y_cells/chunk_y));
+  if (new_columns == columns && new_rows == rows) return;
+
+  std::vector<chunk_extent> new_extent(tasks);
+  for (int task = 0; task < tasks; ++task) {
+    new_extent[task] = {new_columns[task_column[task]], new_columns[task_column[task]+1]-1,
+      new_rows[task_row[task]], new_rows[task_row[task]+1]-1};
+  }
+
+  if (parallel.boss) {
+    g_out << std::endl << " Balancing the chunks at step " << globals.step
+      << ", compute imbalance " << maximum/mean << std::endl;
+    g_out << " Columns start at cells";
+    for (int c = 0; c < chunk_x; ++c) g_out << " " << new_columns[c];
+    g_out << std::endl << " Rows start at cells";
+    for (int r = 0; r < chunk_y; ++r) g_out << " " << new_rows[r];
+    g_out << std::endl << std::endl;
+  }
+
+  const chunk_extent mine = old_extent[parallel.task];
+  const chunk_extent& next = new_extent[parallel.task];
+
+  std::vector<double> state[num_balance_fields];
+  gather_state(globals, mine, state);
+
+  // Each task sends on the part of its state that lies in each new chunk
+  std::vector<int> send_counts(tasks, 0), send_displacements(tasks, 0);
+  std::vector<int> recv_counts(tasks, 0), recv_displacements(tasks, 0);
+  int send_total = 0, recv_total = 0;
+  for (int task = 0; task < tasks; ++task) {
+    send_displacements[task] = send_total;
+    recv_displacements[task] = recv_total;
+    for (int f = 0; f < num_balance_fields; ++f) {
+      const bool nodes = balance_field_nodes[f];
+      send_counts[task] += intersect(owned_box(mine, nodes), held_box(new_extent[task], nodes)).size();
+      recv_counts[task] += intersect(owned_box(old_extent[task], nodes), held_box(next, nodes)).size();
+    }
+    send_total += send_counts[task];
+    recv_total += recv_counts[task];
+  }
+
+  std::vector<double> sent(send_total), received(recv_total);
+  for (int task = 0; task < tasks; ++task) {
+    double *message = &sent[send_displacements[task]];
+    for (int f = 0; f < num_balance_fields; ++f) {
+      const bool nodes = balance_field_nodes[f];
+      const index_box box = intersect(owned_box(mine, nodes), held_box(new_extent[task], nodes));
+      if (box.size() == 0) continue;
+      copy_box(state[f], held_box(mine, nodes), box, message, true);
+      message += box.size();
+    }
+  }
+
+  clover_alltoallv(sent.data(), send_counts.data(), send_displacements.data(),
+    received.data(), recv_counts.data(), recv_displacements.data());
+
+  for (int f = 0; f < num_balance_fields; ++f) {
+    state[f].assign(held_box(next, balance_field_nodes[f]).size(), 0.0);
+  }
+  for (int task = 0; task < tasks; ++task) {
+    double *message = &received[recv_displacements[task]];
+    for (int f = 0; f < num_balance_fields; ++f) {
+      const bool nodes = balance_field_nodes[f];
+      const index_box box = intersect(owned_box(old_extent[task], nodes), held_box(next, nodes));
+      if (box.size() == 0) continue;
+      copy_box(state[f], held_box(next, nodes), box, message, false);
+      message += box.size();
+    }
+  }
+
+  // Rebuild the chunk for its new extent. The set up is not profiled, as at
+  // the start.
+  profiler_type balance_profile = globals.profiler;
+
+  chunk.left = next.left;
+  chunk.right = next.right;
+  chunk.bottom = next.bottom;
+  chunk.top = next.top;
+  chunk.x_max = next.right-next.left+1;
+  chunk.y_max = next.top-next.bottom+1;
+
+  clover_tile_decompose(globals, 0);
+  build_field(globals);
+  clover_free_buffers();
+  clover_allocate_buffers(globals, parallel);
+
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    initialise_chunk(tile, globals);
+  }
+  scatter_state(globals, next, state);
+
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    ideal_gas(globals, tile, false, 0);
+  }
+
+  int fields[NUM_FIELDS];
+  for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
+  fields[field_density0]  = 1;
+  fields[field_energy0]   = 1;
+  fields[field_pressure]  = 1;
+  fields[field_viscosity] = 1;
+  fields[field_density1]  = 1;
+  fields[field_energy1]   = 1;
+  fields[field_xvel0]     = 1;
+  fields[field_yvel0]     = 1;
+  fields[field_xvel1]     = 1;
+  fields[field_yvel1]     = 1;
+
+  update_halo(globals, fields, globals.halo_depth);
+
+  globals.profiler = balance_profile;
+}
+
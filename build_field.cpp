@@ -20,158 +20,150 @@
 
 // @brief  Allocates the data for each mesh chunk
 // @author Wayne Gaudin
-// @details The data fields for the mesh chunk are allocated based on the mesh
-// size.
+// @details The data fields for each mesh chunk are allocated based on the mesh
+// size. All fields of all tiles of a chunk are carved out of a single arena
+// allocation for the chunk, each starting on a 64 byte boundary and followed
+// by the user specified padding.
 
 #include "build_field.h"
 
-// Allocate Kokkos Views for the data arrays
-void build_field(global_variables& globals) {
-
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-
-    const size_t xrange = (globals.chunk.tiles[tile].t_xmax+2) - (globals.chunk.tiles[tile].t_xmin-2) + 1;
-    const size_t yrange = (globals.chunk.tiles[tile].t_ymax+2) - (globals.chunk.tiles[tile].t_ymin-2) + 1;
-
-    // (t_xmin-2:t_xmax+2, t_ymin-2:t_ymax+2)
-    new(&globals.chunk.tiles[tile].field.density0) Kokkos::View<double**>("density0", xrange, yrange);
-    new(&globals.chunk.tiles[tile].field.density1) Kokkos::View<double**>("density1", xrange, yrange);
-    new(&globals.chunk.tiles[tile].field.energy0) Kokkos::View<double**>("energy0", xrange, yrange);
-    new(&globals.chunk.tiles[tile].field.energy1) Kokkos::View<double**>("energy1", xrange, yrange);
-    new(&globals.chunk.tiles[tile].field.pressure) Kokkos::View<double**>("pressure", xrange, yrange);
-    new(&globals.chunk.tiles[tile].field.viscosity) Kokkos::View<double**>("viscosity", xrange, yrange);
-    new(&globals.chunk.tiles[tile].field.soundspeed) Kokkos::View<double**>("soundspeed", xrange, yrange);
-
-    // (t_xmin-2:t_xmax+3, t_ymin-2:t_ymax+3)
-    new(&globals.chunk.tiles[tile].field.xvel0) Kokkos::View<double**>("xvel0", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.xvel1) Kokkos::View<double**>("xvel1", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.yvel0) Kokkos::View<double**>("yvel0", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.yvel1) Kokkos::View<double**>("yvel1", xrange+1, yrange+1);
-
-    // (t_xmin-2:t_xmax+3, t_ymin-2:t_ymax+2)
-    new(&globals.chunk.tiles[tile].field.vol_flux_x) Kokkos::View<double**>("vol_flux_x", xrange+1, yrange);
-    new(&globals.chunk.tiles[tile].field.mass_flux_x) Kokkos::View<double**>("mass_flux_x", xrange+1, yrange);
-    // (t_xmin-2:t_xmax+2, t_ymin-2:t_ymax+3)
-    new(&globals.chunk.tiles[tile].field.vol_flux_y) Kokkos::View<double**>("vol_flux_y", xrange, yrange+1);
-    new(&globals.chunk.tiles[tile].field.mass_flux_y) Kokkos::View<double**>("mass_flux_y", xrange, yrange+1);
-
-    // (t_xmin-2:t_xmax+3, t_ymin-2:t_ymax+3)
-    new(&globals.chunk.tiles[tile].field.work_array1) Kokkos::View<double**>("work_array1", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.work_array2) Kokkos::View<double**>("work_array2", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.work_array3) Kokkos::View<double**>("work_array3", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.work_array4) Kokkos::View<double**>("work_array4", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.work_array5) Kokkos::View<double**>("work_array5", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.work_array6) Kokkos::View<double**>("work_array6", xrange+1, yrange+1);
-    new(&globals.chunk.tiles[tile].field.work_array7) Kokkos::View<double**>("work_array7", xrange+1, yrange+1);
-
-    // (t_xmin-2:t_xmax+2)
-    new(&globals.chunk.tiles[tile].field.cellx) Kokkos::View<double*>("cellx", xrange);
-    new(&globals.chunk.tiles[tile].field.celldx) Kokkos::View<double*>("celldx", xrange);
-    // (t_ymin-2:t_ymax+2)
-    new(&globals.chunk.tiles[tile].field.celly) Kokkos::View<double*>("celly", yrange);
-    new(&globals.chunk.tiles[tile].field.celldy) Kokkos::View<double*>("celldy", yrange);
-    // (t_xmin-2:t_xmax+3)
-    new(&globals.chunk.tiles[tile].field.vertexx) Kokkos::View<double*>("vertexx", xrange+1);
-    new(&globals.chunk.tiles[tile].field.vertexdx) Kokkos::View<double*>("vertexdx", xrange+1);
-    // (t_ymin-2:t_ymax+3)
-    new(&globals.chunk.tiles[tile].field.vertexy) Kokkos::View<double*>("vertexy", yrange+1);
-    new(&globals.chunk.tiles[tile].field.vertexdy) Kokkos::View<double*>("vertexdy", yrange+1);
-
-    // (t_xmin-2:t_xmax+2, t_ymin-2:t_ymax+2)
-    new(&globals.chunk.tiles[tile].field.volume) Kokkos::View<double**>("volume", xrange, yrange);
-    // (t_xmin-2:t_xmax+3, t_ymin-2:t_ymax+2)
-    new(&globals.chunk.tiles[tile].field.xarea) Kokkos::View<double**>("xarea", xrange+1, yrange);
-    // (t_xmin-2:t_xmax+2, t_ymin-2:t_ymax+3)
-    new(&globals.chunk.tiles[tile].field.yarea) Kokkos::View<double**>("yarea", xrange, yrange+1);
-
-    // Zeroing isn't strictly neccessary but it ensures physical pages
-    // are allocated. This prevents first touch overheads in the main code
-    // cycle which can skew timings in the first step
-
-    // Take a reference to the lowest structure, as Kokkos device cannot necessarily chase through the structure.
-    field_type& field = globals.chunk.tiles[tile].field;
-
-    // Nested loop over (t_ymin-2:t_ymax+3) and (t_xmin-2:t_xmax+3) inclusive
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> loop_bounds_1({0,0}, {xrange+1,yrange+1});
+// Alignment of each field within the arena, in doubles (64 bytes)
+#define g_field_align 8
 
-    Kokkos::parallel_for("build_field_zero_1", loop_bounds_1, KOKKOS_LAMBDA (const int j, const int k) {
+// Point a 2D field at the next aligned slot in the arena. With no arena only
+// the offset is advanced, so the same sequence measures and builds a tile.
+// Fields stored in float (see work_type) take half the doubles.
+template<class view_type>
+static void carve_field(view_type& view, double *arena, size_t& offset, const size_t padding, const size_t n0, const size_t n1) {
 
-      field.work_array1(j,k) = 0.0;
-      field.work_array2(j,k) = 0.0;
-      field.work_array3(j,k) = 0.0;
-      field.work_array4(j,k) = 0.0;
-      field.work_array5(j,k) = 0.0;
-      field.work_array6(j,k) = 0.0;
-      field.work_array7(j,k) = 0.0;
+  typedef typename view_type::value_type value_type;
 
-      field.xvel0(j,k) = 0.0;
-      field.xvel1(j,k) = 0.0;
-      field.yvel0(j,k) = 0.0;
-      field.yvel1(j,k) = 0.0;
-
-    });
+  offset = ((offset+g_field_align-1)/g_field_align)*g_field_align;
+  if (arena != nullptr) view = view_type(reinterpret_cast<value_type*>(arena+offset), n0, n1);
+  offset += (n0*n1*sizeof(value_type)+sizeof(double)-1)/sizeof(double)+padding;
+}
 
-    // Nested loop over (t_ymin-2:t_ymax+2) and (t_xmin-2:t_xmax+2) inclusive
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> loop_bounds_2({0,0}, {xrange,yrange});
+// Point a 1D field at the next aligned slot in the arena.
+static void carve_field(Kokkos::View<double*>& view, double *arena, size_t& offset, const size_t padding, const size_t n0) {
 
-    Kokkos::parallel_for("build_field_zero_2", loop_bounds_2, KOKKOS_LAMBDA (const int j, const int k) {
+  offset = ((offset+g_field_align-1)/g_field_align)*g_field_align;
+  if (arena != nullptr) view = Kokkos::View<double*>(arena+offset, n0);
+  offset += n0+padding;
+}
 
-      field.density0(j,k) = 0.0;
-      field.density1(j,k) = 0.0;
-      field.energy0(j,k) = 0.0;
-      field.energy1(j,k) = 0.0;
-      field.pressure(j,k) = 0.0;
-      field.viscosity(j,k) = 0.0;
-      field.soundspeed(j,k) = 0.0;
-      field.volume(j,k) = 0.0;
+// Lay out the fields of a tile with the given extents from offset, returning
+// the offset past them
+static size_t carve_tile(global_variables& globals, int t_xmin, int t_xmax, int t_ymin, int t_ymax,
+  field_type& field, double *arena, size_t offset) {
+
+  const size_t padding = globals.field_padding;
+
+  // h is the halo depth
+  const int h = globals.halo_depth;
+  const size_t xrange = (t_xmax+h) - (t_xmin-h) + 1;
+  const size_t yrange = (t_ymax+h) - (t_ymin-h) + 1;
+
+  // (t_xmin-h:t_xmax+h, t_ymin-h:t_ymax+h)
+  carve_field(field.density0, arena, offset, padding, xrange, yrange);
+  carve_field(field.density1, arena, offset, padding, xrange, yrange);
+  carve_field(field.energy0, arena, offset, padding, xrange, yrange);
+  carve_field(field.energy1, arena, offset, padding, xrange, yrange);
+  carve_field(field.pressure, arena, offset, padding, xrange, yrange);
+  carve_field(field.viscosity, arena, offset, padding, xrange, yrange);
+  carve_field(field.soundspeed, arena, offset, padding, xrange, yrange);
+
+  // (t_xmin-h:t_xmax+h+1, t_ymin-h:t_ymax+h+1)
+  carve_field(field.xvel0, arena, offset, padding, xrange+1, yrange+1);
+  carve_field(field.xvel1, arena, offset, padding, xrange+1, yrange+1);
+  carve_field(field.yvel0, arena, offset, padding, xrange+1, yrange+1);
+  carve_field(field.yvel1, arena, offset, padding, xrange+1, yrange+1);
+
+  // (t_xmin-h:t_xmax+h+1, t_ymin-h:t_ymax+h)
+  carve_field(field.vol_flux_x, arena, offset, padding, xrange+1, yrange);
+  carve_field(field.mass_flux_x, arena, offset, padding, xrange+1, yrange);
+  // (t_xmin-h:t_xmax+h, t_ymin-h:t_ymax+h+1)
+  carve_field(field.vol_flux_y, arena, offset, padding, xrange, yrange+1);
+  carve_field(field.mass_flux_y, arena, offset, padding, xrange, yrange+1);
+
+  // (t_xmin-h:t_xmax+h+1, t_ymin-h:t_ymax+h+1)
+  for (int buffer = 0; buffer < globals.scratch_count; ++buffer) {
+    carve_field(field.scratch[buffer], arena, offset, padding, xrange+1, yrange+1);
+  }
 
-    });
+  // (t_xmin-h:t_xmax+h)
+  carve_field(field.cellx, arena, offset, padding, xrange);
+  carve_field(field.celldx, arena, offset, padding, xrange);
+  // (t_ymin-h:t_ymax+h)
+  carve_field(field.celly, arena, offset, padding, yrange);
+  carve_field(field.celldy, arena, offset, padding, yrange);
+  // (t_xmin-h:t_xmax+h+1)
+  carve_field(field.vertexx, arena, offset, padding, xrange+1);
+  carve_field(field.vertexdx, arena, offset, padding, xrange+1);
+  // (t_ymin-h:t_ymax+h+1)
+  carve_field(field.vertexy, arena, offset, padding, yrange+1);
+  carve_field(field.vertexdy, arena, offset, padding, yrange+1);
+
+  // (t_xmin-h:t_xmax+h, t_ymin-h:t_ymax+h)
+  carve_field(field.volume, arena, offset, padding, xrange, yrange);
+  // (t_xmin-h:t_xmax+h+1, t_ymin-h:t_ymax+h)
+  carve_field(field.xarea, arena, offset, padding, xrange+1, yrange);
+  // (t_xmin-h:t_xmax+h, t_ymin-h:t_ymax+h+1)
+  carve_field(field.yarea, arena, offset, padding, xrange, yrange+1);
+
+  return offset;
+}
 
-    // Nested loop over (t_ymin-2:t_ymax+2) and (t_xmin-2:t_xmax+3) inclusive
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> loop_bounds_3({0,0}, {xrange+1,yrange});
+static size_t carve_tile(global_variables& globals, int tile, double *arena, size_t offset) {
 
-    Kokkos::parallel_for("build_field_zero_3", loop_bounds_3, KOKKOS_LAMBDA (const int j, const int k) {
+  tile_type& t = globals.tiles[tile];
+  return carve_tile(globals, t.t_xmin, t.t_xmax, t.t_ymin, t.t_ymax, t.field, arena, offset);
+}
 
-      field.vol_flux_x(j,k) = 0.0;
-      field.mass_flux_x(j,k) = 0.0;
-      field.xarea(j,k) = 0.0;
-    });
+// Bytes the fields of a tile with the given extents take in the arena,
+// without allocating them
+size_t tile_field_bytes(global_variables& globals, int t_xmin, int t_xmax, int t_ymin, int t_ymax) {
 
-    // Nested loop over (t_ymin-2:t_ymax+3) and (t_xmin-2:t_xmax+2) inclusive
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> loop_bounds_4({0,0}, {xrange,yrange+1});
+  // Without an arena no View is assigned, so the field is never touched
+  field_type unused;
+  return carve_tile(globals, t_xmin, t_xmax, t_ymin, t_ymax, unused, nullptr, 0)*sizeof(double);
+}
 
-    Kokkos::parallel_for("build_field_zero_4", loop_bounds_4, KOKKOS_LAMBDA (const int j, const int k) {
+// Allocate the field arena of each chunk and the Kokkos Views of the data
+// arrays within it
+void build_field(global_variables& globals) {
 
-      field.vol_flux_y(j,k) = 0.0;
-      field.mass_flux_y(j,k) = 0.0;
-      field.yarea(j,k) = 0.0;
-    });
+  for (int c = 0; c < globals.local_chunks; ++c) {
+    chunk_type& chunk = globals.chunks[c];
+    const int first = chunk.first_tile;
+    const int last = first+globals.tiles_per_chunk;
 
+    // Measure every tile to size the arena
+    size_t arena_size = 0;
+    for (int tile = first; tile < last; ++tile) {
+      size_t tile_start = ((arena_size+g_field_align-1)/g_field_align)*g_field_align;
+      arena_size = carve_tile(globals, tile, nullptr, tile_start);
+      globals.tiles[tile].field_bytes = (arena_size-tile_start)*sizeof(double);
+    }
 
-    // (t_xmin-2:t_xmax+2) inclusive
-    Kokkos::parallel_for("build_field_zero_5", xrange, KOKKOS_LAMBDA (const int j) {
-      field.cellx(j) = 0.0;
-      field.celldx(j) = 0.0;
-    });
+    chunk.field_arena = Kokkos::View<double*>(Kokkos::ViewAllocateWithoutInitializing("field_arena"), arena_size);
 
-    // (t_ymin-2:t_ymax+2) inclusive
-    Kokkos::parallel_for("build_field_zero_6", yrange, KOKKOS_LAMBDA (const int k) {
-      field.celly(k) = 0.0;
-      field.celldy(k) = 0.0;
-    });
+    size_t offset = 0;
+    for (int tile = first; tile < last; ++tile) {
+      offset = ((offset+g_field_align-1)/g_field_align)*g_field_align;
+      offset = carve_tile(globals, tile, chunk.field_arena.data(), offset);
 
-    // (t_xmin-2:t_xmax+3) inclusive
-    Kokkos::parallel_for("build_field_zero_6", xrange+1, KOKKOS_LAMBDA (const int j) {
-      field.vertexx(j) = 0.0;
-      field.vertexdx(j) = 0.0;
-    });
+      globals.tiles[tile].field.dt_cell = Kokkos::View<double*>("dt_cell", NUM_DT_CELL);
+      globals.tiles[tile].field.hm_dt_cell = Kokkos::create_mirror_view(globals.tiles[tile].field.dt_cell);
+    }
 
-    // (t_ymin-2:t_ymax+3) inclusive
-    Kokkos::parallel_for("build_field_zero_7", yrange+1, KOKKOS_LAMBDA (const int k) {
-      field.vertexy(k) = 0.0;
-      field.vertexdy(k) = 0.0;
+    // Zeroing isn't strictly neccessary but it ensures physical pages
+    // are allocated. This prevents first touch overheads in the main code
+    // cycle which can skew timings in the first step. With a single arena this
+    // is the only first touch of the field data.
+    Kokkos::View<double*> field_arena = chunk.field_arena;
+    Kokkos::parallel_for("build_field_zero", arena_size, KOKKOS_LAMBDA (const size_t i) {
+      field_arena(i) = 0.0;
     });
-
   }
 
 }
@@ -24,6 +24,7 @@
 #include "definitions.h"
 
 void build_field(global_variables& globals);
+size_t tile_field_bytes(global_variables& globals, int t_xmin, int t_xmax, int t_ymin, int t_ymax);
 
 #endif
 
@@ -19,57 +19,70 @@
 
 
 #include "calc_dt.h"
+#include "viscosity.h"
+#include "report.h"
+
+#include <cstdint>
 
 //  @brief Fortran timestep kernel
 //  @author Wayne Gaudin
 //  @details Calculates the minimum timestep on the mesh chunk based on the CFL
 //  condition, the velocity gradient and the velocity divergence. A safety
-//  factor is used to ensure numerical stability.
+//  factor is used to ensure numerical stability. When fused the artificial
+//  viscosity is calculated and stored in the same pass instead of being read.
 void calc_dt_kernel(
+  const exec_space& space,
   int x_min,int x_max, int y_min, int y_max,
-  double dtmin,
+  bool fused,
   double dtc_safe,
   double dtu_safe,
   double dtv_safe,
   double dtdiv_safe,
-  Kokkos::View<double**>& xarea,
-  Kokkos::View<double**>& yarea,
-  Kokkos::View<double*>& cellx,
-  Kokkos::View<double*>& celly,
+  field_view& xarea,
+  field_view& yarea,
   Kokkos::View<double*>& celldx,
   Kokkos::View<double*>& celldy,
-  Kokkos::View<double**>& volume,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity_a,
-  Kokkos::View<double**>& soundspeed,
-  Kokkos::View<double**>& xvel0, Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& dt_min,
+  field_view& volume,
+  field_view& density0,
+  field_view& pressure,
+  work_view& viscosity_a,
+  work_view& soundspeed,
+  field_view& xvel0, field_view& yvel0,
   double& dt_min_val,
   int& dtl_control,
-  double& xl_pos,
-  double& yl_pos,
   int& jldt,
-  int& kldt,
-  int& small) {
+  int& kldt) {
 
 
-  small = 0;
   dt_min_val = g_big;
-  double jk_control = 1.1;
+
+  // The location of the minimum is packed with the criterion that set it, as
+  // the Fortran jk_control did: loc = 4*(cell offset in the tile) + control-1.
+  // It is 64 bit as four times the cells of a large tile overflows an int
+  const int64_t x_cells = x_max-x_min+1;
+  typedef Kokkos::MinLoc<double,int64_t> reducer_type;
+  reducer_type::value_type dt_min_loc;
 
   // DO k=y_min,y_max
   //   DO j=x_min,x_max
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min+1, y_min+1}, {x_max+2, y_max+2});
+  field_policy policy(space, {x_min+1, y_min+1}, {x_max+2, y_max+2});
   Kokkos::parallel_reduce("calc_dt", policy,
-    KOKKOS_LAMBDA (const int j, const int k, double &dt_min_val) {
+    KOKKOS_LAMBDA (const int j, const int k, reducer_type::value_type& dt_min_loc) {
 
       double dsx = celldx(j);
       double dsy = celldy(k);
 
+      double visc;
+      if (fused) {
+        visc = viscosity_cell(j, k, celldx, celldy, density0, pressure, xvel0, yvel0);
+        viscosity_a(j,k) = visc;
+      }
+      else {
+        visc = viscosity_a(j,k);
+      }
+
       double cc = soundspeed(j,k)*soundspeed(j,k);
-      cc = cc+2.0*viscosity_a(j,k)/density0(j,k);
+      cc = cc+2.0*visc/density0(j,k);
       cc = MAX(sqrt(cc),g_small);
 
       double dtct = dtc_safe*MIN(dsx,dsy)/cc;
@@ -100,39 +113,39 @@ void calc_dt_kernel(
         dtdivt = g_big;
       }
 
-      dt_min_val = MIN(dt_min_val,dtct);
-      dt_min_val = MIN(dt_min_val,dtut);
-      dt_min_val = MIN(dt_min_val,dtvt);
-      dt_min_val = MIN(dt_min_val,dtdivt);
+      // Controls are 1 sound, 2 xvel, 3 yvel, 4 div; ties go to the lowest
+      double dt_cell = dtct;
+      int control = 1;
+      if (dtut < dt_cell) { dt_cell = dtut; control = 2; }
+      if (dtvt < dt_cell) { dt_cell = dtvt; control = 3; }
+      if (dtdivt < dt_cell) { dt_cell = dtdivt; control = 4; }
+
+      if (dt_cell < dt_min_loc.val) {
+        dt_min_loc.val = dt_cell;
+        dt_min_loc.loc = 4*((k-(y_min+1))*x_cells+(j-(x_min+1)))+control-1;
+      }
 
     },
-    Kokkos::Min<double>(dt_min_val));
+    reducer_type(dt_min_loc));
 
-  //  Extract the mimimum timestep information
-  dtl_control = 10.01*(jk_control-(int)(jk_control));
-  jk_control = jk_control-(jk_control-(int)(jk_control));
-  jldt = ((int)jk_control) % x_max;
-  kldt = 1+(jk_control/x_max);
-  // TODO: cannot do this with GPU memory directly
-  //xl_pos = cellx(jldt+1); // Offset by 1 because of Fortran halos in original code
-  //yl_pos = celly(kldt+1);
-
-  if (dt_min_val < dtmin) small=1;
-
-  if (small != 0) {
-    std::cout
-      << "Timestep information:" << std::endl
-      << "j, k                 : " << jldt << " " << kldt << std::endl
-      << "x, y                 : " << cellx(jldt) << " " << celly(kldt) << std::endl
-      << "timestep : " << dt_min_val << std::endl
-      << "Cell velocities;" << std::endl
-      << xvel0(jldt  ,kldt  ) << " " << yvel0(jldt  ,kldt  ) << std::endl
-      << xvel0(jldt+1,kldt  ) << " " << yvel0(jldt+1,kldt  ) << std::endl
-      << xvel0(jldt+1,kldt+1) << " " << yvel0(jldt+1,kldt+1) << std::endl
-      << xvel0(jldt  ,kldt+1) << " " << yvel0(jldt  ,kldt+1) << std::endl
-      << "density, energy, pressure, soundspeed " << std::endl
-      << density0(jldt,kldt) << " " << energy0(jldt,kldt) << " " << pressure(jldt,kldt) << " " << soundspeed(jldt,kldt) << std::endl;
+  // If no cell gave a timestep, as when they are all NaN, the location is
+  // still the identity of the reduction and names no cell of the tile
+  if (dt_min_loc.loc < 0 || dt_min_loc.loc >= 4*x_cells*(y_max-y_min+1)) {
+    report_error((char *)"calc_dt", (char *)"no cell gave a valid timestep");
   }
+
+  //  Extract the mimimum timestep information
+  dt_min_val = MIN(dt_min_loc.val, g_big);
+  dtl_control = 1+(int)(dt_min_loc.loc%4);
+  const int64_t jk_cell = dt_min_loc.loc/4;
+  const int j = x_min+1+(int)(jk_cell%x_cells);
+  const int k = y_min+1+(int)(jk_cell/x_cells);
+
+  // Report in the Fortran indexing used by the rest of the output, counting
+  // from the first cell of the tile whatever the halo depth
+  jldt = j-x_min;
+  kldt = k-y_min;
+
 }
 
 
@@ -140,51 +153,77 @@ void calc_dt_kernel(
 //  @brief Driver for the timestep kernels
 //  @author Wayne Gaudin
 //  @details Invokes the user specified timestep kernel.
-void calc_dt(global_variables& globals, int tile, double& local_dt, std::string& local_control, double& xl_pos, double& yl_pos, int& jldt, int& kldt) {
+void calc_dt(global_variables& globals, int tile, double& local_dt, int& local_control, int& jldt, int& kldt) {
 
   local_dt = g_big;
 
-  int l_control;
-  int small = 0;
-
   calc_dt_kernel(
-    globals.chunk.tiles[tile].t_xmin,
-    globals.chunk.tiles[tile].t_xmax,
-    globals.chunk.tiles[tile].t_ymin,
-    globals.chunk.tiles[tile].t_ymax,
-    globals.dtmin,
+    globals.tiles[tile].space,
+    globals.tiles[tile].t_xmin,
+    globals.tiles[tile].t_xmax,
+    globals.tiles[tile].t_ymin,
+    globals.tiles[tile].t_ymax,
+    globals.fused_timestep,
     globals.dtc_safe,
     globals.dtu_safe,
     globals.dtv_safe,
     globals.dtdiv_safe,
-    globals.chunk.tiles[tile].field.xarea,
-    globals.chunk.tiles[tile].field.yarea,
-    globals.chunk.tiles[tile].field.cellx,
-    globals.chunk.tiles[tile].field.celly,
-    globals.chunk.tiles[tile].field.celldx,
-    globals.chunk.tiles[tile].field.celldy,
-    globals.chunk.tiles[tile].field.volume,
-    globals.chunk.tiles[tile].field.density0,
-    globals.chunk.tiles[tile].field.energy0,
-    globals.chunk.tiles[tile].field.pressure,
-    globals.chunk.tiles[tile].field.viscosity,
-    globals.chunk.tiles[tile].field.soundspeed,
-    globals.chunk.tiles[tile].field.xvel0,
-    globals.chunk.tiles[tile].field.yvel0,
-    globals.chunk.tiles[tile].field.work_array1,
+    globals.tiles[tile].field.xarea,
+    globals.tiles[tile].field.yarea,
+    globals.tiles[tile].field.celldx,
+    globals.tiles[tile].field.celldy,
+    globals.tiles[tile].field.volume,
+    globals.tiles[tile].field.density0,
+    globals.tiles[tile].field.pressure,
+    globals.tiles[tile].field.viscosity,
+    globals.tiles[tile].field.soundspeed,
+    globals.tiles[tile].field.xvel0,
+    globals.tiles[tile].field.yvel0,
     local_dt,
-    l_control,
-    xl_pos,
-    yl_pos,
+    local_control,
     jldt,
-    kldt,
-    small
+    kldt
   );
 
-  if (l_control == 1) local_control = "sound";
-  if (l_control == 2) local_control = "xvel";
-  if (l_control == 3) local_control = "yvel";
-  if (l_control == 4) local_control = "div";
+}
+
 
+//  @brief Values describing the cell that controls the timestep
+//  @details Copies the position, velocities and state of cell jldt, kldt of
+//  the tile back to the host in one transfer, through the tile's persistent
+//  buffer. Only the tile's own instance is waited for.
+void calc_dt_cell(global_variables& globals, int tile, int jldt, int kldt, double cell[NUM_DT_CELL]) {
+
+  field_type& field = globals.tiles[tile].field;
+  const int j = globals.tiles[tile].t_xmin+jldt;
+  const int k = globals.tiles[tile].t_ymin+kldt;
+
+  Kokkos::View<double*> dt_cell = field.dt_cell;
+  Kokkos::View<double*> cellx = field.cellx;
+  Kokkos::View<double*> celly = field.celly;
+  field_view xvel0 = field.xvel0;
+  field_view yvel0 = field.yvel0;
+  field_view density0 = field.density0;
+  field_view energy0 = field.energy0;
+  field_view pressure = field.pressure;
+  work_view soundspeed = field.soundspeed;
+
+  const exec_space& space = globals.tiles[tile].space;
+  Kokkos::parallel_for("calc_dt_cell", Kokkos::RangePolicy<>(space, 0, 1), KOKKOS_LAMBDA (const int) {
+    dt_cell(0) = cellx(j);
+    dt_cell(1) = celly(k);
+    dt_cell(2) = xvel0(j  ,k  ); dt_cell(3) = yvel0(j  ,k  );
+    dt_cell(4) = xvel0(j+1,k  ); dt_cell(5) = yvel0(j+1,k  );
+    dt_cell(6) = xvel0(j+1,k+1); dt_cell(7) = yvel0(j+1,k+1);
+    dt_cell(8) = xvel0(j  ,k+1); dt_cell(9) = yvel0(j  ,k+1);
+    dt_cell(10) = density0(j,k);
+    dt_cell(11) = energy0(j,k);
+    dt_cell(12) = pressure(j,k);
+    dt_cell(13) = soundspeed(j,k);
+  });
+  Kokkos::deep_copy(space, field.hm_dt_cell, dt_cell);
+  space.fence();
+
+  for (int i = 0; i < NUM_DT_CELL; ++i) cell[i] = field.hm_dt_cell(i);
 }
 
@@ -25,7 +25,8 @@
 
 #include <string>
 
-void calc_dt(global_variables& globals, int tile, double& local_dt, std::string& local_control, double& xl_pos, double& yl_pos, int& jldt, int& kldt);
+void calc_dt(global_variables& globals, int tile, double& local_dt, int& local_control, int& jldt, int& kldt);
+void calc_dt_cell(global_variables& globals, int tile, int jldt, int kldt, double cell[NUM_DT_CELL]);
 
 #endif
 
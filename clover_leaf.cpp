@@ -79,6 +79,11 @@ int main(int argc, char *argv[]) {
 
   hydro(*globals, parallel);
 
+  // The chunks and tiles hold Kokkos Views, so go before Kokkos is finalised
+  clover_free_halo_plans();
+  delete[] globals->tiles;
+  delete[] globals->chunks;
+  delete[] globals->chunk_task;
   delete globals;
   
   // Finilise programming models
@@ -24,23 +24,74 @@
 //  environment, including initialisation, mesh decompostion, reductions and
 //  halo exchange using explicit buffers.
 // 
-//  Note the halo exchange is currently coded as simply as possible and no 
-//  optimisations have been implemented, such as post receives before sends or packing
-//  buffers with multiple data fields. This is intentional so the effect of these
-//  optimisations can be measured on large systems, as and when they are added.
+//  Each message carries all of the requested fields, packed into one buffer
+//  in a single launch per neighbour.
 // 
-//  Even without these modifications CloverLeaf weak scales well on moderately sized
-//  systems of the order of 10K cores.
+//  The exchange can be split into clover_exchange_start and
+//  clover_exchange_finish so that work which does not read the halo overlaps
+//  the left and right messages. With exchange_corners the corners come from
+//  the diagonal neighbours, so all eight messages go out in a single phase.
+//  Each field mask and depth gets a plan of buffer offsets and persistent
+//  requests on first use, so later exchanges only pack and restart them.
+//
+//  With cartesian_topology the halo messages go over a Cartesian
+//  communicator that MPI may reorder to suit the machine, and with
+//  neighbour_exchange each phase is a single neighbourhood collective on it
+//  rather than point to point messages.
+//
+//  With shared_exchange the receive buffers live in an MPI shared memory
+//  window, and a chunk writes each message to a neighbour on the same node
+//  straight into that neighbour's receive buffer. Only zero length messages
+//  then pass between them, one to say a message is written and one to say it
+//  has been unpacked and its buffer may be written again.
+//
+//  A task may hold several chunks. Each chunk exchanges with its neighbours
+//  as if it were alone on its task, except that a message to another chunk
+//  of the same task is packed straight into that chunk's receive buffer and
+//  no MPI message is sent.
 
 #include "comms.h"
 #include "pack_kernel.h"
+#include "report.h"
 
 #include <mpi.h>
 
 #include <cstdlib>
+#include <map>
+#include <vector>
 
 extern std::ostream g_out;
 
+namespace {
+// Communicator of the halo messages. Unless it is Cartesian it is
+// MPI_COMM_WORLD. Either way globals.chunk_task gives the rank in it of the
+// task holding each chunk.
+MPI_Comm halo_comm = MPI_COMM_WORLD;
+
+// Graph of the up to eight neighbours of the chunk, for the single phase
+// exchange by neighbourhood collectives, and the message each of its
+// neighbours takes in order
+MPI_Comm corner_comm = MPI_COMM_NULL;
+int corner_comm_messages[8];
+int corner_comm_count = 0;
+
+// The non-blocking reduction between clover_min_start and clover_min_finish,
+// of a value and the task holding it
+struct { double value; int task; } reduction_value, reduction_result;
+MPI_Request reduction_request = MPI_REQUEST_NULL;
+
+// Tasks on the node, the window of their receive arenas, and the messages
+// that go through it. For each such message there is a zero length message
+// from the chunk once it has unpacked what the neighbour wrote, and one from
+// the neighbour once it has unpacked what the chunk wrote.
+MPI_Comm node_comm = MPI_COMM_NULL;
+MPI_Win shared_window = MPI_WIN_NULL;
+bool shared_message[8] = {false, false, false, false, false, false, false, false};
+MPI_Request free_send[8], free_recv[8];
+bool free_send_pending[8] = {false, false, false, false, false, false, false, false};
+bool free_recv_pending[8] = {false, false, false, false, false, false, false, false};
+}
+
 // Set up parallel structure
 parallel_::parallel_() {
 
@@ -66,50 +117,108 @@ void clover_barrier() {
 
 
 
-//  This decomposes the mesh into a number of chunks.
-//  The number of chunks may be a multiple of the number of mpi tasks
-//  Doesn't always return the best split if there are few factors
-//  All factors need to be stored and the best picked. But its ok for now
-void clover_decompose(global_variables& globals, parallel_& parallel, int x_cells, int y_cells, int& left, int& right, int& bottom, int& top) {
-
-  int number_of_chunks = globals.number_of_chunks;
-
-  // 2D Decomposition of the mesh
-
-  double mesh_ratio = (double)x_cells/(double)y_cells;
+// Splits number into a grid of nx by ny whose ratio is closest to ratio
+// without exceeding it, or a single row or column if there is no such split
+static void clover_factor(int number, double ratio, int& nx, int& ny) {
 
-  int chunk_x = number_of_chunks;
-  int chunk_y = 1;
+  nx = number;
+  ny = 1;
 
   int split_found = 0; // Used to detect 1D decomposition
 
   double factor_x, factor_y;
 
-  for (int c = 1; c <= number_of_chunks; ++c) {
-    if (number_of_chunks % c == 0) {
-      factor_x = number_of_chunks/(double)c;
+  for (int c = 1; c <= number; ++c) {
+    if (number % c == 0) {
+      factor_x = number/(double)c;
       factor_y = c;
       // Compare the factor ratio with the mesh ratio
-      if (factor_x / factor_y <= mesh_ratio) {
-        chunk_y = c;
-        chunk_x = number_of_chunks/c;
+      if (factor_x / factor_y <= ratio) {
+        ny = c;
+        nx = number/c;
         split_found = 1;
         break;
       }
     }
   }
 
-  if (split_found == 0 || chunk_y == number_of_chunks) { // Prime number or 1D decomp detected
-    if (mesh_ratio >= 1.0) {
-      chunk_x = number_of_chunks;
-      chunk_y = 1;
+  if (split_found == 0 || ny == number) { // Prime number or 1D decomp detected
+    if (ratio >= 1.0) {
+      nx = number;
+      ny = 1;
     }
     else {
-      chunk_x = 1;
-      chunk_y = number_of_chunks;
+      nx = 1;
+      ny = number;
+    }
+  }
+}
+
+// The part that item i falls in when count items are split into parts as
+// evenly as possible, the first count%parts parts taking one more
+static int clover_split_part(int i, int count, int parts) {
+
+  const int delta = count/parts;
+  const int mod = count%parts;
+  if (i < mod*(delta+1)) return i/(delta+1);
+  return mod+(i-mod*(delta+1))/delta;
+}
+
+//  This decomposes the mesh into a number of chunks.
+//  The number of chunks may be a multiple of the number of mpi tasks
+//  Doesn't always return the best split if there are few factors
+//  All factors need to be stored and the best picked. But its ok for now
+//
+//  Each task holds a block of neighbouring chunks when the tasks split the
+//  chunk grid evenly enough, otherwise a run of chunks in number order, so
+//  the same decomposition can run on any number of tasks up to the number of
+//  chunks. The chunks this task holds are set up in globals.chunks.
+void clover_decompose(global_variables& globals, parallel_& parallel, int x_cells, int y_cells) {
+
+  int number_of_chunks = globals.number_of_chunks;
+
+  // 2D Decomposition of the mesh
+
+  double mesh_ratio = (double)x_cells/(double)y_cells;
+
+  int chunk_x, chunk_y;
+  clover_factor(number_of_chunks, mesh_ratio, chunk_x, chunk_y);
+
+  // The rank of this task among those holding chunks. With one chunk per
+  // task, chunks are numbered along x first, which is the row major order of
+  // a Cartesian communicator with dimensions (y, x), so the rank MPI gives
+  // the task there is also its chunk number less one.
+  int task_rank = parallel.task;
+  if (globals.cartesian_topology) {
+    int dims[2] = {chunk_y, chunk_x};
+    int periods[2] = {0, 0};
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 1, &halo_comm);
+    MPI_Comm_rank(halo_comm, &task_rank);
+  }
+
+  // Map the chunks to the tasks, in blocks of the chunk grid if the task grid
+  // fits in it
+  int task_x, task_y;
+  clover_factor(parallel.max_task, (double)chunk_x/(double)chunk_y, task_x, task_y);
+  const bool blocks = (task_x <= chunk_x && task_y <= chunk_y);
+
+  globals.chunk_task = new int[number_of_chunks];
+  globals.local_chunks = 0;
+  for (int cy = 1; cy <= chunk_y; ++cy) {
+    for (int cx = 1; cx <= chunk_x; ++cx) {
+      const int n = chunk_x*(cy-1)+cx-1;
+      if (blocks) {
+        globals.chunk_task[n] = task_x*clover_split_part(cy-1, chunk_y, task_y)+clover_split_part(cx-1, chunk_x, task_x);
+      }
+      else {
+        globals.chunk_task[n] = (int)(((long)n*parallel.max_task)/number_of_chunks);
+      }
+      if (globals.chunk_task[n] == task_rank) globals.local_chunks++;
     }
   }
 
+  globals.chunks = new chunk_type[globals.local_chunks];
+
   int delta_x = x_cells / chunk_x;
   int delta_y = y_cells / chunk_y;
   int mod_x = x_cells % chunk_x;
@@ -120,6 +229,7 @@ void clover_decompose(global_variables& globals, parallel_& parallel, int x_cell
   int add_x_prev = 0;
   int add_y_prev = 0;
   int cnk = 1;
+  int local = 0;
   for (int cy = 1; cy <= chunk_y; ++cy) {
     for (int cx = 1; cx <= chunk_x; ++cx) {
       int add_x = 0;
@@ -127,21 +237,48 @@ void clover_decompose(global_variables& globals, parallel_& parallel, int x_cell
       if (cx <= mod_x) add_x = 1;
       if (cy <= mod_y) add_y = 1;
 
-      if (cnk == parallel.task+1) {
-        left   = (cx-1)*delta_x+1+add_x_prev;
-        right  = left+delta_x-1+add_x;
-        bottom = (cy-1)*delta_y+1+add_y_prev;
-        top    = bottom+delta_y-1+add_y;
-
-        globals.chunk.chunk_neighbours[chunk_left]=chunk_x*(cy-1)+cx-1;
-        globals.chunk.chunk_neighbours[chunk_right]=chunk_x*(cy-1)+cx+1;
-        globals.chunk.chunk_neighbours[chunk_bottom]=chunk_x*(cy-2)+cx;
-        globals.chunk.chunk_neighbours[chunk_top]=chunk_x*(cy)+cx;
-
-        if (cx == 1)       globals.chunk.chunk_neighbours[chunk_left]=external_face;
-        if (cx == chunk_x) globals.chunk.chunk_neighbours[chunk_right]=external_face;
-        if (cy == 1)       globals.chunk.chunk_neighbours[chunk_bottom]=external_face;
-        if (cy == chunk_y) globals.chunk.chunk_neighbours[chunk_top]=external_face;
+      if (globals.chunk_task[cnk-1] == task_rank) {
+        chunk_type& chunk = globals.chunks[local];
+
+        chunk.task = parallel.task;
+        chunk.number = cnk;
+        chunk.first_tile = local*globals.tiles_per_chunk;
+
+        chunk.left   = (cx-1)*delta_x+1+add_x_prev;
+        chunk.right  = chunk.left+delta_x-1+add_x;
+        chunk.bottom = (cy-1)*delta_y+1+add_y_prev;
+        chunk.top    = chunk.bottom+delta_y-1+add_y;
+
+        chunk.left_boundary   = 1;
+        chunk.bottom_boundary = 1;
+        chunk.right_boundary  = x_cells;
+        chunk.top_boundary    = y_cells;
+        chunk.x_min = 1;
+        chunk.y_min = 1;
+        chunk.x_max = chunk.right-chunk.left+1;
+        chunk.y_max = chunk.top-chunk.bottom+1;
+
+        chunk.chunk_neighbours[chunk_left]=chunk_x*(cy-1)+cx-1;
+        chunk.chunk_neighbours[chunk_right]=chunk_x*(cy-1)+cx+1;
+        chunk.chunk_neighbours[chunk_bottom]=chunk_x*(cy-2)+cx;
+        chunk.chunk_neighbours[chunk_top]=chunk_x*(cy)+cx;
+
+        if (cx == 1)       chunk.chunk_neighbours[chunk_left]=external_face;
+        if (cx == chunk_x) chunk.chunk_neighbours[chunk_right]=external_face;
+        if (cy == 1)       chunk.chunk_neighbours[chunk_bottom]=external_face;
+        if (cy == chunk_y) chunk.chunk_neighbours[chunk_top]=external_face;
+
+        chunk.corner_neighbours[corner_bottom_left]=chunk_x*(cy-2)+cx-1;
+        chunk.corner_neighbours[corner_bottom_right]=chunk_x*(cy-2)+cx+1;
+        chunk.corner_neighbours[corner_top_left]=chunk_x*(cy)+cx-1;
+        chunk.corner_neighbours[corner_top_right]=chunk_x*(cy)+cx+1;
+
+        if (cx == 1 || cy == 1)             chunk.corner_neighbours[corner_bottom_left]=external_face;
+        if (cx == chunk_x || cy == 1)       chunk.corner_neighbours[corner_bottom_right]=external_face;
+        if (cx == 1 || cy == chunk_y)       chunk.corner_neighbours[corner_top_left]=external_face;
+        if (cx == chunk_x || cy == chunk_y) chunk.corner_neighbours[corner_top_right]=external_face;
+
+        local = local+1;
       }
 
       if (cx <= mod_x) add_x_prev = add_x_prev+1;
@@ -152,28 +289,62 @@ void clover_decompose(global_variables& globals, parallel_& parallel, int x_cell
       if (cy <= mod_y) add_y_prev=add_y_prev+1;
   }
 
+  if (globals.neighbour_exchange && globals.exchange_corners) {
+    // The Cartesian communicator only knows the edge neighbours, so the
+    // single phase exchange uses a graph of all eight built over it
+    chunk_type& chunk = globals.chunks[0];
+    int neighbours[8];
+    corner_comm_count = 0;
+    for (int face = 0; face < 4; ++face) {
+      if (chunk.chunk_neighbours[face] == external_face) continue;
+      neighbours[corner_comm_count] = globals.chunk_task[chunk.chunk_neighbours[face]-1];
+      corner_comm_messages[corner_comm_count++] = face;
+    }
+    for (int corner = 0; corner < 4; ++corner) {
+      if (chunk.corner_neighbours[corner] == external_face) continue;
+      neighbours[corner_comm_count] = globals.chunk_task[chunk.corner_neighbours[corner]-1];
+      corner_comm_messages[corner_comm_count++] = message_bottom_left+corner;
+    }
+    MPI_Dist_graph_create_adjacent(halo_comm, corner_comm_count, neighbours, MPI_UNWEIGHTED,
+      corner_comm_count, neighbours, MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &corner_comm);
+  }
+
   if (parallel.boss) {
     g_out << std::endl
       << "Mesh ratio of " << mesh_ratio << std::endl
-      << "Decomposing the mesh into " << chunk_x << " by " << chunk_y << " chunks" << std::endl
-      << "Decomposing the chunk with " << globals.tiles_per_chunk << " tiles" << std::endl
+      << "Decomposing the mesh into " << chunk_x << " by " << chunk_y << " chunks" << std::endl;
+    if (number_of_chunks > parallel.max_task) {
+      if (blocks) {
+        g_out << "Placing the chunks on " << task_x << " by " << task_y << " tasks" << std::endl;
+      }
+      else {
+        g_out << "Placing the chunks on " << parallel.max_task << " tasks in number order" << std::endl;
+      }
+    }
+    g_out << "Decomposing the chunk with " << globals.tiles_per_chunk << " tiles" << std::endl
       << std::endl;
   }
 }
 
 
-void clover_tile_decompose(global_variables& globals, int chunk_x_cells, int chunk_y_cells) {
+// Number of tiles across and up a chunk when it is split into
+// tiles_per_chunk tiles, matching the ratio of the chunk's sides
+void clover_tile_split(global_variables& globals, int c, int& tile_x, int& tile_y) {
 
-  int chunk_mesh_ratio = (double)chunk_x_cells/(double)chunk_y_cells;
+  chunk_type& chunk = globals.chunks[c];
+  const int chunk_x_cells = chunk.x_max;
+  const int chunk_y_cells = chunk.y_max;
 
-  int tile_x = globals.tiles_per_chunk;
-  int tile_y = 1;
+  double chunk_mesh_ratio = (double)chunk_x_cells/(double)chunk_y_cells;
+
+  tile_x = globals.tiles_per_chunk;
+  tile_y = 1;
 
   int split_found = 0; // Used to detect 1D decomposition
   for (int t = 1; t <= globals.tiles_per_chunk; ++t) {
     if (globals.tiles_per_chunk % t == 0) {
-      int factor_x = globals.tiles_per_chunk/(double)t;
-      int factor_y = t;
+      double factor_x = globals.tiles_per_chunk/(double)t;
+      double factor_y = t;
       // Compare the factor ratio with the mesh ratio
       if (factor_x/factor_y <= chunk_mesh_ratio) {
         tile_y = t;
@@ -194,6 +365,18 @@ void clover_tile_decompose(global_variables& globals, int chunk_x_cells, int chu
       tile_y = globals.tiles_per_chunk;
     }
   }
+}
+
+// Splits a chunk into tiles_per_chunk tiles, numbered in globals.tiles from
+// the chunk's first tile
+void clover_tile_decompose(global_variables& globals, int c) {
+
+  chunk_type& chunk = globals.chunks[c];
+  const int chunk_x_cells = chunk.x_max;
+  const int chunk_y_cells = chunk.y_max;
+
+  int tile_x, tile_y;
+  clover_tile_split(globals, c, tile_x, tile_y);
 
   int chunk_delta_x = chunk_x_cells/tile_x;
   int chunk_delta_y = chunk_y_cells/tile_y;
@@ -203,7 +386,7 @@ void clover_tile_decompose(global_variables& globals, int chunk_x_cells, int chu
 
   int add_x_prev = 0;
   int add_y_prev = 0;
-  int tile = 0; // Used to index globals.chunk.tiles array
+  int tile = chunk.first_tile; // Used to index globals.tiles array
   for (int ty = 1; ty <= tile_y; ++ty) {
     for (int tx = 1; tx <= tile_x; ++tx) {
       int add_x = 0;
@@ -211,51 +394,61 @@ void clover_tile_decompose(global_variables& globals, int chunk_x_cells, int chu
       if (tx <= chunk_mod_x) add_x = 1;
       if (ty <= chunk_mod_y) add_y = 1;
 
-      int left   = globals.chunk.left+(tx-1)*chunk_delta_x+add_x_prev;
+      int left   = chunk.left+(tx-1)*chunk_delta_x+add_x_prev;
       int right  = left+chunk_delta_x-1+add_x;
-      int bottom = globals.chunk.bottom+(ty-1)*chunk_delta_y+add_y_prev;
+      int bottom = chunk.bottom+(ty-1)*chunk_delta_y+add_y_prev;
       int top    = bottom+chunk_delta_y-1+add_y;
 
-      globals.chunk.tiles[tile].tile_neighbours[tile_left]=tile_x*(ty-1)+tx-1;
-      globals.chunk.tiles[tile].tile_neighbours[tile_right]=tile_x*(ty-1)+tx+1;
-      globals.chunk.tiles[tile].tile_neighbours[tile_bottom]=tile_x*(ty-2)+tx;
-      globals.chunk.tiles[tile].tile_neighbours[tile_top]=tile_x*(ty)+tx;
+      globals.tiles[tile].chunk = c;
+
+      // Indices into globals.tiles, which counts from 0
+      globals.tiles[tile].tile_neighbours[tile_left]=chunk.first_tile+tile_x*(ty-1)+tx-2;
+      globals.tiles[tile].tile_neighbours[tile_right]=chunk.first_tile+tile_x*(ty-1)+tx;
+      globals.tiles[tile].tile_neighbours[tile_bottom]=chunk.first_tile+tile_x*(ty-2)+tx-1;
+      globals.tiles[tile].tile_neighbours[tile_top]=chunk.first_tile+tile_x*(ty)+tx-1;
 
 
       // initial set the external tile mask to 0 for each tile
       for (int i = 0; i < 4; ++i) {
-        globals.chunk.tiles[tile].external_tile_mask[i] = 0;
+        globals.tiles[tile].external_tile_mask[i] = 0;
       }
 
       if (tx == 1) {
-        globals.chunk.tiles[tile].tile_neighbours[tile_left] = external_tile;
-        globals.chunk.tiles[tile].external_tile_mask[tile_left] = 1;
+        globals.tiles[tile].tile_neighbours[tile_left] = external_tile;
+        globals.tiles[tile].external_tile_mask[tile_left] = 1;
       }
       if (tx == tile_x) {
-        globals.chunk.tiles[tile].tile_neighbours[tile_right] = external_tile;
-        globals.chunk.tiles[tile].external_tile_mask[tile_right] = 1;
+        globals.tiles[tile].tile_neighbours[tile_right] = external_tile;
+        globals.tiles[tile].external_tile_mask[tile_right] = 1;
       }
       if (ty == 1) {
-        globals.chunk.tiles[tile].tile_neighbours[tile_bottom] = external_tile;
-        globals.chunk.tiles[tile].external_tile_mask[tile_bottom] = 1;
+        globals.tiles[tile].tile_neighbours[tile_bottom] = external_tile;
+        globals.tiles[tile].external_tile_mask[tile_bottom] = 1;
       }
       if (ty == tile_y) {
-        globals.chunk.tiles[tile].tile_neighbours[tile_top] = external_tile;
-        globals.chunk.tiles[tile].external_tile_mask[tile_top] = 1;
+        globals.tiles[tile].tile_neighbours[tile_top] = external_tile;
+        globals.tiles[tile].external_tile_mask[tile_top] = 1;
       }
 
       if (tx <= chunk_mod_x) add_x_prev = add_x_prev+1;
 
-      globals.chunk.tiles[tile].t_xmin = 1;
-      globals.chunk.tiles[tile].t_xmax = right - left + 1;
-      globals.chunk.tiles[tile].t_ymin = 1;
-      globals.chunk.tiles[tile].t_ymax = top - bottom + 1;
+      // The first halo cell is always index 0, whatever the halo depth
+      globals.tiles[tile].t_xmin = globals.halo_depth - 1;
+      globals.tiles[tile].t_xmax = globals.halo_depth - 1 + right - left;
+      globals.tiles[tile].t_ymin = globals.halo_depth - 1;
+      globals.tiles[tile].t_ymax = globals.halo_depth - 1 + top - bottom;
+
+      // A halo is filled from the neighbour's cells, so it can be no deeper
+      // than the narrowest tile
+      if (right - left + 1 < globals.halo_depth || top - bottom + 1 < globals.halo_depth) {
+        report_error((char *)"clover_tile_decompose", (char *)"tiles are narrower than halo_depth");
+      }
 
  
-      globals.chunk.tiles[tile].t_left = left;
-      globals.chunk.tiles[tile].t_right = right;
-      globals.chunk.tiles[tile].t_top = top;
-      globals.chunk.tiles[tile].t_bottom = bottom;
+      globals.tiles[tile].t_left = left;
+      globals.tiles[tile].t_right = right;
+      globals.tiles[tile].t_top = top;
+      globals.tiles[tile].t_bottom = bottom;
 
       tile = tile+1;
     }
@@ -266,29 +459,216 @@ void clover_tile_decompose(global_variables& globals, int chunk_x_cells, int chu
 }
 
 
+Kokkos::View<double*>& clover_message_buffer(chunk_type& chunk, int message, bool send);
+Kokkos::View<double*>::HostMirror& clover_host_message_buffer(chunk_type& chunk, int message, bool send);
+
+// Points a buffer and its host mirror at the next part of the arenas
+static void clover_carve_buffer(Kokkos::View<double*>& arena, Kokkos::View<double*>::HostMirror& hm_arena,
+  size_t& offset, const size_t size, Kokkos::View<double*>& buffer, Kokkos::View<double*>::HostMirror& hm_buffer) {
+
+  buffer = Kokkos::View<double*>(arena.data()+offset, size);
+  hm_buffer = Kokkos::View<double*>::HostMirror(hm_arena.data()+offset, size);
+  offset += size;
+}
+
+// The chunk across a message, and the message that chunk receives it as
+static int clover_message_neighbour(chunk_type& chunk, int message) {
+
+  if (message <= message_top) return chunk.chunk_neighbours[message];
+  return chunk.corner_neighbours[message-message_bottom_left];
+}
+
+static int clover_opposite_message(int message) {
+
+  if (message <= message_top) return message ^ 1;
+  return message_bottom_left + message_top_right - message;
+}
+
+// The index in globals.chunks of a chunk this task holds, or -1 if another
+// task holds it
+static int clover_local_chunk(global_variables& globals, int number) {
+
+  for (int c = 0; c < globals.local_chunks; ++c) {
+    if (globals.chunks[c].number == number) return c;
+  }
+  return -1;
+}
+
+// Whether a message goes to a chunk on another task. Messages between chunks
+// of the same task are packed straight into the receive buffer and need no
+// MPI message.
+static bool clover_remote_message(global_variables& globals, chunk_type& chunk, int message) {
+
+  const int neighbour = clover_message_neighbour(chunk, message);
+  return neighbour != external_face && clover_local_chunk(globals, neighbour) < 0;
+}
+
+// The position of a chunk among those its task holds, which sets the tags of
+// the messages it receives so that those to different chunks of one task are
+// told apart
+static int clover_task_index(global_variables& globals, int number) {
+
+  int index = 0;
+  for (int n = 0; n < number-1; ++n) {
+    if (globals.chunk_task[n] == globals.chunk_task[number-1]) index++;
+  }
+  return index;
+}
+
+// Allocates the receive arena in a window shared by the tasks on the node.
+// The kernels unpack from it in place if they can reach host memory.
+static void clover_share_arena(global_variables& globals, const size_t arena_size) {
+
+  chunk_type& chunk = globals.chunks[0];
+
+  MPI_Comm_split_type(halo_comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+
+  // Each task's part of the window is placed in its own memory
+  MPI_Info info;
+  MPI_Info_create(&info);
+  MPI_Info_set(info, (char *)"alloc_shared_noncontig", (char *)"true");
+  double *base;
+  MPI_Win_allocate_shared(arena_size*sizeof(double), sizeof(double), info, node_comm, &base, &shared_window);
+  MPI_Info_free(&info);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, shared_window);
+
+  chunk.hm_rcv_arena = Kokkos::View<double*>::HostMirror(base, arena_size);
+  if (Kokkos::SpaceAccessibility<Kokkos::DefaultExecutionSpace, Kokkos::HostSpace>::accessible) {
+    chunk.rcv_arena = Kokkos::View<double*>(base, arena_size);
+  }
+  else {
+    chunk.rcv_arena = Kokkos::View<double*>("rcv_buffers", arena_size);
+  }
+}
+
+// Points the send buffer of each message to a neighbour on the node at the
+// receive buffer it arrives in, so packing writes the message in place, and
+// sets up the zero length messages that say a receive buffer is free again
+static void clover_share_send_buffers(global_variables& globals) {
+
+  chunk_type& chunk = globals.chunks[0];
+
+  int node_size;
+  MPI_Comm_size(node_comm, &node_size);
+
+  // Where each task on the node receives each message in its arena
+  int offsets[8];
+  for (int message = 0; message < 8; ++message) {
+    offsets[message] = clover_host_message_buffer(chunk, message, false).data() - chunk.hm_rcv_arena.data();
+  }
+  std::vector<int> node_offsets(8*node_size);
+  MPI_Allgather(offsets, 8, MPI_INT, node_offsets.data(), 8, MPI_INT, node_comm);
+
+  MPI_Group halo_group, node_group;
+  MPI_Comm_group(halo_comm, &halo_group);
+  MPI_Comm_group(node_comm, &node_group);
+
+  for (int message = 0; message < 8; ++message) {
+    // Corner messages are only sent in the single phase exchange
+    if (message >= message_bottom_left && !globals.exchange_corners) continue;
+
+    const int neighbour = clover_message_neighbour(chunk, message);
+    if (neighbour == external_face) continue;
+
+    int rank = globals.chunk_task[neighbour-1];
+    int node_rank;
+    MPI_Group_translate_ranks(halo_group, 1, &rank, node_group, &node_rank);
+    if (node_rank == MPI_UNDEFINED) continue;
+
+    MPI_Aint size;
+    int disp_unit;
+    double *neighbour_base;
+    MPI_Win_shared_query(shared_window, node_rank, &size, &disp_unit, &neighbour_base);
+    double *target = neighbour_base + node_offsets[8*node_rank+clover_opposite_message(message)];
+
+    // The chunks either side of a face have the same extent along it, so the
+    // buffers match in size
+    const size_t length = clover_host_message_buffer(chunk, message, true).extent(0);
+    clover_host_message_buffer(chunk, message, true) = Kokkos::View<double*>::HostMirror(target, length);
+    if (Kokkos::SpaceAccessibility<Kokkos::DefaultExecutionSpace, Kokkos::HostSpace>::accessible) {
+      clover_message_buffer(chunk, message, true) = Kokkos::View<double*>(target, length);
+    }
+
+    MPI_Send_init(NULL, 0, MPI_DOUBLE, rank, 20+message, halo_comm, &free_send[message]);
+    MPI_Recv_init(NULL, 0, MPI_DOUBLE, rank, 20+clover_opposite_message(message), halo_comm, &free_recv[message]);
+    shared_message[message] = true;
+  }
+
+  MPI_Group_free(&halo_group);
+  MPI_Group_free(&node_group);
+}
+
+// Points the send buffer of each message to another chunk of this task at
+// the receive buffer it arrives in, so packing writes the message in place
+static void clover_local_send_buffers(global_variables& globals, chunk_type& chunk) {
+
+  for (int message = 0; message < 8; ++message) {
+    const int neighbour = clover_message_neighbour(chunk, message);
+    if (neighbour == external_face) continue;
+
+    const int local = clover_local_chunk(globals, neighbour);
+    if (local < 0) continue;
+
+    chunk_type& target = globals.chunks[local];
+    const int received = clover_opposite_message(message);
+    clover_message_buffer(chunk, message, true) = clover_message_buffer(target, received, false);
+    clover_host_message_buffer(chunk, message, true) = clover_host_message_buffer(target, received, false);
+  }
+}
+
 void clover_allocate_buffers(global_variables& globals, parallel_& parallel) {
 
-  // Unallocated buffers for external boundaries caused issues on some systems so they are now
-  //  all allocated
-  if (parallel.task == globals.chunk.task) {
-    new(&globals.chunk.left_snd_buffer)   Kokkos::View<double*>("left_snd_buffer",   10*2*(globals.chunk.y_max+5));
-    new(&globals.chunk.left_rcv_buffer)   Kokkos::View<double*>("left_rcv_buffer",   10*2*(globals.chunk.y_max+5));
-    new(&globals.chunk.right_snd_buffer)  Kokkos::View<double*>("right_snd_buffer",  10*2*(globals.chunk.y_max+5));
-    new(&globals.chunk.right_rcv_buffer)  Kokkos::View<double*>("right_rcv_buffer",  10*2*(globals.chunk.y_max+5));
-    new(&globals.chunk.bottom_snd_buffer) Kokkos::View<double*>("bottom_snd_buffer", 10*2*(globals.chunk.x_max+5));
-    new(&globals.chunk.bottom_rcv_buffer) Kokkos::View<double*>("bottom_rcv_buffer", 10*2*(globals.chunk.x_max+5));
-    new(&globals.chunk.top_snd_buffer)    Kokkos::View<double*>("top_snd_buffer",    10*2*(globals.chunk.x_max+5));
-    new(&globals.chunk.top_rcv_buffer)    Kokkos::View<double*>("top_rcv_buffer",    10*2*(globals.chunk.x_max+5));
+  for (int c = 0; c < globals.local_chunks; ++c) {
+    chunk_type& chunk = globals.chunks[c];
+
+    // Unallocated buffers for external boundaries caused issues on some systems so they are now
+    //  all allocated. Each holds up to ten fields to the full halo depth h.
+    const int h = globals.halo_depth;
+    const size_t left_right_size = 10*h*(chunk.y_max+2*h+1);
+    const size_t bottom_top_size = 10*h*(chunk.x_max+2*h+1);
+    const size_t corner_size = 10*h*h;
+    const size_t arena_size = 2*left_right_size + 2*bottom_top_size + 4*corner_size;
+
+    chunk.snd_arena = Kokkos::View<double*>("snd_buffers", arena_size);
 
     // Create host mirrors of device buffers. This makes this, and deep_copy, a no-op if the View is in host memory already.
-    globals.chunk.hm_left_snd_buffer   = Kokkos::create_mirror_view(globals.chunk.left_snd_buffer);
-    globals.chunk.hm_left_rcv_buffer   = Kokkos::create_mirror_view(globals.chunk.left_rcv_buffer);
-    globals.chunk.hm_right_snd_buffer  = Kokkos::create_mirror_view(globals.chunk.right_snd_buffer);
-    globals.chunk.hm_right_rcv_buffer  = Kokkos::create_mirror_view(globals.chunk.right_rcv_buffer);
-    globals.chunk.hm_bottom_snd_buffer = Kokkos::create_mirror_view(globals.chunk.bottom_snd_buffer);
-    globals.chunk.hm_bottom_rcv_buffer = Kokkos::create_mirror_view(globals.chunk.bottom_rcv_buffer);
-    globals.chunk.hm_top_snd_buffer    = Kokkos::create_mirror_view(globals.chunk.top_snd_buffer);
-    globals.chunk.hm_top_rcv_buffer    = Kokkos::create_mirror_view(globals.chunk.top_rcv_buffer);
+    chunk.hm_snd_arena = Kokkos::create_mirror_view(chunk.snd_arena);
+
+    // Only a task holding a single chunk can share its arena
+    if (globals.shared_exchange) {
+      clover_share_arena(globals, arena_size);
+    }
+    else {
+      chunk.rcv_arena = Kokkos::View<double*>("rcv_buffers", arena_size);
+      chunk.hm_rcv_arena = Kokkos::create_mirror_view(chunk.rcv_arena);
+    }
+
+    size_t snd_offset = 0;
+    size_t rcv_offset = 0;
+    clover_carve_buffer(chunk.snd_arena, chunk.hm_snd_arena, snd_offset, left_right_size, chunk.left_snd_buffer, chunk.hm_left_snd_buffer);
+    clover_carve_buffer(chunk.rcv_arena, chunk.hm_rcv_arena, rcv_offset, left_right_size, chunk.left_rcv_buffer, chunk.hm_left_rcv_buffer);
+    clover_carve_buffer(chunk.snd_arena, chunk.hm_snd_arena, snd_offset, left_right_size, chunk.right_snd_buffer, chunk.hm_right_snd_buffer);
+    clover_carve_buffer(chunk.rcv_arena, chunk.hm_rcv_arena, rcv_offset, left_right_size, chunk.right_rcv_buffer, chunk.hm_right_rcv_buffer);
+    clover_carve_buffer(chunk.snd_arena, chunk.hm_snd_arena, snd_offset, bottom_top_size, chunk.bottom_snd_buffer, chunk.hm_bottom_snd_buffer);
+    clover_carve_buffer(chunk.rcv_arena, chunk.hm_rcv_arena, rcv_offset, bottom_top_size, chunk.bottom_rcv_buffer, chunk.hm_bottom_rcv_buffer);
+    clover_carve_buffer(chunk.snd_arena, chunk.hm_snd_arena, snd_offset, bottom_top_size, chunk.top_snd_buffer, chunk.hm_top_snd_buffer);
+    clover_carve_buffer(chunk.rcv_arena, chunk.hm_rcv_arena, rcv_offset, bottom_top_size, chunk.top_rcv_buffer, chunk.hm_top_rcv_buffer);
+
+    // Corner blocks for the single phase exchange
+    for (int corner = 0; corner < 4; ++corner) {
+      clover_carve_buffer(chunk.snd_arena, chunk.hm_snd_arena, snd_offset, corner_size, chunk.corner_snd_buffer[corner], chunk.hm_corner_snd_buffer[corner]);
+      clover_carve_buffer(chunk.rcv_arena, chunk.hm_rcv_arena, rcv_offset, corner_size, chunk.corner_rcv_buffer[corner], chunk.hm_corner_rcv_buffer[corner]);
+    }
+  }
+
+  // Every receive buffer has to be in place before another chunk's send
+  // buffer can point at it
+  for (int c = 0; c < globals.local_chunks; ++c) {
+    clover_local_send_buffers(globals, globals.chunks[c]);
+  }
+
+  if (globals.shared_exchange) {
+    clover_share_send_buffers(globals);
   }
 }
 
@@ -299,6 +679,18 @@ void clover_sum(double& value) {
   value = total;
 }
 
+// Sums count values onto the boss in a single reduction
+void clover_sum(double *values, int count) {
+
+  if (count > MAX_REDUCTION) {
+    report_error((char *)"clover_sum", (char *)"too many values for one reduction");
+  }
+
+  double totals[MAX_REDUCTION];
+  MPI_Reduce(values, totals, count, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  for (int i = 0; i < count; ++i) values[i] = totals[i];
+}
+
 void clover_min(double& value) {
 
   double minimum = value;
@@ -309,12 +701,78 @@ void clover_min(double& value) {
 
 }
 
+// The minimum over the tasks along with the task holding it, the lowest one
+// if several do
+void clover_min(double& value, int& task) {
+
+  struct { double value; int task; } local, minimum;
+  local.value = value;
+  MPI_Comm_rank(MPI_COMM_WORLD, &local.task);
+
+  MPI_Allreduce(&local, &minimum, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+
+  value = minimum.value;
+  task = minimum.task;
+}
+
+// A non-blocking minimum and the task holding it, which has to be completed
+// by clover_min_finish before the value is read. Only one may be in flight
+// at a time.
+void clover_min_start(double& value) {
+
+  if (reduction_request != MPI_REQUEST_NULL) {
+    report_error((char *)"clover_min_start", (char *)"reduction already in flight");
+  }
+
+  reduction_value.value = value;
+  MPI_Comm_rank(MPI_COMM_WORLD, &reduction_value.task);
+  MPI_Iallreduce(&reduction_value, &reduction_result, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD, &reduction_request);
+}
+
+void clover_min_finish(double& value, int& task) {
+
+  if (reduction_request == MPI_REQUEST_NULL) {
+    report_error((char *)"clover_min_finish", (char *)"no reduction in flight");
+  }
+
+  MPI_Wait(&reduction_request, MPI_STATUS_IGNORE);
+  value = reduction_result.value;
+  task = reduction_result.task;
+}
+
+// Sends count values from task root to every task
+void clover_broadcast(double *values, int count, int root) {
+
+  MPI_Bcast(values, count, MPI_DOUBLE, root, MPI_COMM_WORLD);
+}
+
 void clover_allgather(double value, double *values) {
 
   values[0] = value; // Just to ensure it will work in serial
   MPI_Allgather(&value, 1, MPI_DOUBLE, values, 1, MPI_DOUBLE, MPI_COMM_WORLD);
 }
 
+// Gathers count values from every task onto the boss, task by task
+void clover_gather(double *values, int count, double *gathered) {
+
+  MPI_Gather(values, count, MPI_DOUBLE, gathered, count, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+}
+
+// Gathers count values from every task onto every task, task by task
+void clover_allgather(double *values, int count, double *gathered) {
+
+  MPI_Allgather(values, count, MPI_DOUBLE, gathered, count, MPI_DOUBLE, MPI_COMM_WORLD);
+}
+
+// Sends a part of values to every task, and receives a part from each, with
+// the length and start of each part given task by task
+void clover_alltoallv(double *values, int *counts, int *displacements,
+  double *received, int *received_counts, int *received_displacements) {
+
+  MPI_Alltoallv(values, counts, displacements, MPI_DOUBLE,
+    received, received_counts, received_displacements, MPI_DOUBLE, MPI_COMM_WORLD);
+}
+
 
 void clover_check_error(int& error) {
 
@@ -326,1710 +784,589 @@ void clover_check_error(int& error) {
 
 }
 
-void clover_exchange(global_variables& globals, int fields[NUM_FIELDS], const int depth) {
-
-  // Assuming 1 patch per task, this will be changed
-
+//  @brief Halo exchange plan
+//  @details The buffer offsets and persistent MPI requests for one chunk,
+//  field mask and depth. The same few masks are exchanged every step, so each
+//  plan is built on first use and its requests are only restarted after that.
+//  The first phase holds the left and right messages, and in the single phase
+//  exchange also the bottom, top and corner ones; the second phase holds the
+//  bottom and top messages of the two phase exchange. Messages to other
+//  chunks of the same task have no requests. With neighbourhood collectives
+//  each phase is instead one collective, given by the length of the message
+//  to each neighbour of the communicator, zero for those not in the phase,
+//  and where it starts in the buffer arenas.
+namespace {
+struct halo_plan {
+  int chunk; // Index in globals.chunks
+  int fields[NUM_FIELDS];
+  int depth;
+  bool corners; // Single phase exchange with the diagonal neighbours
   int left_right_offset[NUM_FIELDS];
   int bottom_top_offset[NUM_FIELDS];
+  int corner_offset[NUM_FIELDS];
+  int end_pack_index_left_right;
+  int end_pack_index_bottom_top;
+  int end_pack_index_corner;
+  MPI_Request first[16];
+  int first_count;
+  MPI_Request second[4];
+  int second_count;
+  bool collective; // Neighbourhood collectives rather than point to point
+  MPI_Comm comm;
+  int first_counts[8];
+  int second_counts[8];
+  int displacements[8];
+  MPI_Request collective_request;
+};
+
+std::map<long, halo_plan> halo_plans;
+
+// The plans of the exchange between clover_exchange_start and
+// clover_exchange_finish, one for each chunk of the task. Only one exchange
+// may be in flight at a time.
+std::vector<halo_plan*> in_flight;
+
+// Tags of the messages a chunk receives are offset by its position among the
+// chunks of its task, in steps clear of the shared memory tags
+const int tag_stride = 32;
+
+// Adds a persistent send and receive with a neighbour to a phase. A message
+// through shared memory is already in place, so only says it is written.
+void clover_plan_message(int message, double *snd_buffer, double *rcv_buffer, int total_size, int task,
+  int tag_send, int tag_recv, MPI_Request *requests, int& count) {
+
+  if (shared_message[message]) total_size = 0;
+
+  MPI_Send_init(snd_buffer, total_size, MPI_DOUBLE, task, tag_send, halo_comm, &requests[count]);
+  MPI_Recv_init(rcv_buffer, total_size, MPI_DOUBLE, task, tag_recv, halo_comm, &requests[count+1]);
+  count += 2;
+}
 
-  MPI_Request request[4] = {0};
-  int message_count = 0;
+// Adds the messages with the neighbour across a face or corner of a chunk to
+// a phase, unless that neighbour is another chunk of the task. The tags name
+// the side each message leaves from, so the neighbour receives it as the
+// opposite side.
+void clover_plan_neighbour(global_variables& globals, chunk_type& chunk, int message, int total_size,
+  int tag_send, int tag_recv, MPI_Request *requests, int& count) {
+
+  if (!clover_remote_message(globals, chunk, message)) return;
+
+  const int neighbour = clover_message_neighbour(chunk, message);
+  clover_plan_message(message,
+    clover_host_message_buffer(chunk, message, true).data(),
+    clover_host_message_buffer(chunk, message, false).data(),
+    total_size, globals.chunk_task[neighbour-1],
+    tag_send+tag_stride*clover_task_index(globals, neighbour),
+    tag_recv+tag_stride*clover_task_index(globals, chunk.number),
+    requests, count);
+}
 
-  int cnk = 1;
+// The tile holding a corner of a chunk, or -1 if the chunk has no neighbour
+// across it
+int clover_corner_tile(global_variables& globals, chunk_type& chunk, int corner) {
 
-  int end_pack_index_left_right = 0;
-  int end_pack_index_bottom_top = 0;
-  for (int field = 0; field < NUM_FIELDS; ++field) {
-    if (fields[field] == 1) {
-      left_right_offset[field] = end_pack_index_left_right;
-      bottom_top_offset[field] = end_pack_index_bottom_top;
-      end_pack_index_left_right += depth * (globals.chunk.y_max+5);
-      end_pack_index_bottom_top += depth * (globals.chunk.x_max+5);
-    }
-  }
+  if (chunk.corner_neighbours[corner] == external_face) return -1;
 
-  if (globals.chunk.chunk_neighbours[chunk_left] != external_face) {
-    // do left exchanges
-    // Find left hand tiles
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_left] == 1) {
-        clover_pack_left(globals, tile, fields, depth, left_right_offset);
-      }
+  const int x_face = (corner == corner_bottom_left || corner == corner_top_left) ? tile_left : tile_right;
+  const int y_face = (corner == corner_bottom_left || corner == corner_bottom_right) ? tile_bottom : tile_top;
+  for (int tile = chunk.first_tile; tile < chunk.first_tile+globals.tiles_per_chunk; ++tile) {
+    if (globals.tiles[tile].external_tile_mask[x_face] == 1 &&
+        globals.tiles[tile].external_tile_mask[y_face] == 1) {
+      return tile;
     }
-
-    // send and recv messages to the left
-    clover_send_recv_message_left(globals,
-      globals.chunk.left_snd_buffer,
-      globals.chunk.left_rcv_buffer,
-      end_pack_index_left_right,
-      1, 2,
-      request[message_count], request[message_count+1]);
-    message_count += 2;
   }
+  return -1;
+}
 
-  if (globals.chunk.chunk_neighbours[chunk_right] != external_face) {
-    // do right exchanges
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_right] == 1) {
-        clover_pack_right(globals, tile, fields, depth, left_right_offset);
-      }
-    }
+// Finds the plan of a chunk for a field mask and depth, building it on first
+// use
+halo_plan& clover_halo_plan(global_variables& globals, int c, int fields[NUM_FIELDS], int depth) {
 
-    // send message to the right
-    clover_send_recv_message_right(globals,
-      globals.chunk.right_snd_buffer,
-      globals.chunk.right_rcv_buffer,
-      end_pack_index_left_right,
-      2, 1,
-      request[message_count], request[message_count+1]);
-    message_count += 2;
+  long key = 0;
+  for (int field = 0; field < NUM_FIELDS; ++field) {
+    if (fields[field] == 1) key |= 1L << field;
   }
+  key |= (long)depth << NUM_FIELDS;
+  if (globals.exchange_corners) key |= 1L << (NUM_FIELDS+16);
+  key |= (long)c << (NUM_FIELDS+17);
 
-  // make a call to wait / sync
-  MPI_Waitall(message_count, request, MPI_STATUS_IGNORE);
+  std::map<long, halo_plan>::iterator found = halo_plans.find(key);
+  if (found != halo_plans.end()) return found->second;
 
-  // Copy back to the device
-  Kokkos::deep_copy(globals.chunk.left_rcv_buffer, globals.chunk.hm_left_rcv_buffer);
-  Kokkos::deep_copy(globals.chunk.right_rcv_buffer, globals.chunk.hm_right_rcv_buffer);
+  chunk_type& chunk = globals.chunks[c];
 
-  // unpack in left direction
-  if (globals.chunk.chunk_neighbours[chunk_left] != external_face) {
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_left] == 1) {
-        clover_unpack_left(globals, fields, tile, depth, left_right_offset);
-      }
+  halo_plan& plan = halo_plans[key];
+  plan.chunk = c;
+  plan.depth = depth;
+  plan.corners = globals.exchange_corners;
+
+  plan.end_pack_index_left_right = 0;
+  plan.end_pack_index_bottom_top = 0;
+  plan.end_pack_index_corner = 0;
+  for (int field = 0; field < NUM_FIELDS; ++field) {
+    plan.fields[field] = fields[field];
+    if (fields[field] == 1) {
+      plan.left_right_offset[field] = plan.end_pack_index_left_right;
+      plan.bottom_top_offset[field] = plan.end_pack_index_bottom_top;
+      plan.corner_offset[field] = plan.end_pack_index_corner;
+      plan.end_pack_index_left_right += depth * (chunk.y_max+2*globals.halo_depth+1);
+      plan.end_pack_index_bottom_top += depth * (chunk.x_max+2*globals.halo_depth+1);
+      plan.end_pack_index_corner += depth * depth;
     }
   }
 
-  // unpack in right direction
-  if (globals.chunk.chunk_neighbours[chunk_right] != external_face) {
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_right] == 1) {
-        clover_unpack_right(globals, fields, tile, depth, left_right_offset);
-      }
+  plan.first_count = 0;
+  plan.second_count = 0;
+  plan.collective = globals.neighbour_exchange;
+  if (plan.collective) {
+    // A Cartesian communicator orders the neighbours by dimension, the
+    // negative side first, and the dimensions are (y, x)
+    const int cart_messages[4] = {message_bottom, message_top, message_left, message_right};
+    plan.comm = plan.corners ? corner_comm : halo_comm;
+    const int neighbours = plan.corners ? corner_comm_count : 4;
+    for (int n = 0; n < neighbours; ++n) {
+      const int message = plan.corners ? corner_comm_messages[n] : cart_messages[n];
+      const bool edge = (message <= message_top);
+      const bool external = edge && (chunk.chunk_neighbours[message] == external_face);
+      const int size = (message == message_left || message == message_right) ? plan.end_pack_index_left_right :
+        edge ? plan.end_pack_index_bottom_top : plan.end_pack_index_corner;
+      const bool first = plan.corners || message == message_left || message == message_right;
+
+      plan.first_counts[n] = (!external && first) ? size : 0;
+      plan.second_counts[n] = (!external && !first) ? size : 0;
+      plan.displacements[n] = clover_message_buffer(chunk, message, true).data() - chunk.snd_arena.data();
     }
+    return plan;
   }
 
-  message_count = 0;
-  for (int i = 0; i < 4; ++i) request[i] = 0;
+  clover_plan_neighbour(globals, chunk, message_left, plan.end_pack_index_left_right, 1, 2, plan.first, plan.first_count);
+  clover_plan_neighbour(globals, chunk, message_right, plan.end_pack_index_left_right, 2, 1, plan.first, plan.first_count);
 
-  if (globals.chunk.chunk_neighbours[chunk_bottom] != external_face) {
-    // do bottom exchanges
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_bottom] == 1) {
-        clover_pack_bottom(globals, tile, fields, depth, bottom_top_offset);
-      }
-    }
+  MPI_Request *bottom_top = plan.corners ? plan.first : plan.second;
+  int& bottom_top_count = plan.corners ? plan.first_count : plan.second_count;
+  clover_plan_neighbour(globals, chunk, message_bottom, plan.end_pack_index_bottom_top, 3, 4, bottom_top, bottom_top_count);
+  clover_plan_neighbour(globals, chunk, message_top, plan.end_pack_index_bottom_top, 4, 3, bottom_top, bottom_top_count);
 
-    // send message downwards
-    clover_send_recv_message_bottom(globals,
-      globals.chunk.bottom_snd_buffer,
-      globals.chunk.bottom_rcv_buffer,
-      end_pack_index_bottom_top,
-      3, 4,
-      request[message_count], request[message_count+1]);
-    message_count += 2;
+  if (plan.corners) {
+    for (int corner = 0; corner < 4; ++corner) {
+      if (clover_corner_tile(globals, chunk, corner) < 0) continue;
+      clover_plan_neighbour(globals, chunk, message_bottom_left+corner, plan.end_pack_index_corner,
+        5+corner, 5+(3-corner), plan.first, plan.first_count);
+    }
   }
 
-  if (globals.chunk.chunk_neighbours[chunk_top] != external_face) {
-    // do top exchanges
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_top] == 1) {
-        clover_pack_top(globals, tile, fields, depth, bottom_top_offset);
-      }
-    }
+  return plan;
+}
 
-    // send message upwards
-    clover_send_recv_message_top(globals,
-      globals.chunk.top_snd_buffer,
-      globals.chunk.top_rcv_buffer,
-      end_pack_index_bottom_top,
-      4, 3,
-      request[message_count], request[message_count+1]);
-    message_count += 2;
+// Waits until the neighbour has unpacked the last message written into its
+// receive buffer through shared memory, before the next is written there
+void clover_claim_buffer(int message) {
 
-  }
+  if (!shared_message[message]) return;
 
-  // need to make a call to wait / sync
-  MPI_Waitall(message_count, request, MPI_STATUS_IGNORE);
+  if (free_recv_pending[message]) {
+    MPI_Wait(&free_recv[message], MPI_STATUS_IGNORE);
+    MPI_Win_sync(shared_window);
+  }
+  MPI_Start(&free_recv[message]);
+  free_recv_pending[message] = true;
+}
 
-  // Copy back to the device
-  Kokkos::deep_copy(globals.chunk.bottom_rcv_buffer, globals.chunk.hm_bottom_rcv_buffer);
-  Kokkos::deep_copy(globals.chunk.top_rcv_buffer, globals.chunk.hm_top_rcv_buffer);
+// Makes the messages written through shared memory visible to the neighbours,
+// before the zero length messages that say so
+void clover_sync_written() {
 
-  // unpack in top direction
-  if (globals.chunk.chunk_neighbours[chunk_top] != external_face) {
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_top] == 1) {
-        clover_unpack_top(globals, fields, tile, depth, bottom_top_offset);
-      }
-    }
-  }
+  if (shared_window == MPI_WIN_NULL) return;
 
-  // unpack in bottom direction
-  if (globals.chunk.chunk_neighbours[chunk_bottom] != external_face) {
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-      if (globals.chunk.tiles[tile].external_tile_mask[tile_bottom] == 1) {
-        clover_unpack_bottom(globals, fields, tile, depth, bottom_top_offset);
-      }
-    }
-  }
+  Kokkos::fence();
+  MPI_Win_sync(shared_window);
 }
 
+// Tells the neighbours on the node that the messages they wrote are unpacked
+void clover_release_buffers(halo_plan& plan) {
 
-void clover_pack_left(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int left_right_offset[NUM_FIELDS]) {
+  if (shared_window == MPI_WIN_NULL) return;
 
-  int t_offset = (globals.chunk.tiles[tile].t_bottom - globals.chunk.bottom) * depth;
+  Kokkos::fence();
+  MPI_Win_sync(shared_window);
+  for (int message = 0; message < 8; ++message) {
+    if (!shared_message[message]) continue;
+    if (message >= message_bottom_left && !plan.corners) continue;
 
-  if (fields[field_density0] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel0]+t_offset);
-  }
-  if (fields[field_xvel1] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel1]+t_offset);
-  }
-  if (fields[field_yvel0] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel0]+t_offset);
-  }
-  if (fields[field_yvel1] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel1]+t_offset);
-  }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_vol_flux_x]+t_offset);
-  }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_vol_flux_y]+t_offset);
-  }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_mass_flux_x]+t_offset);
-  }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_pack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.left_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_mass_flux_y]+t_offset);
+    if (free_send_pending[message]) MPI_Wait(&free_send[message], MPI_STATUS_IGNORE);
+    MPI_Start(&free_send[message]);
+    free_send_pending[message] = true;
   }
 }
 
-void clover_send_recv_message_left(
-  global_variables& globals,
-  Kokkos::View<double*>& left_snd_buffer,
-  Kokkos::View<double*>& left_rcv_buffer,
-  int total_size, int tag_send, int tag_recv,
-  MPI_Request& req_send, MPI_Request& req_recv) {
-
-  // First copy send buffer from device to host
-  Kokkos::deep_copy(globals.chunk.hm_left_snd_buffer, left_snd_buffer);
+// Packs the message across one face of a chunk from the tiles along it, and
+// copies it to the host if it goes to another task
+void clover_pack_face(global_variables& globals, halo_plan& plan, int message, int face, int offset[NUM_FIELDS]) {
 
-  int left_task = globals.chunk.chunk_neighbours[chunk_left] - 1;
+  chunk_type& chunk = globals.chunks[plan.chunk];
 
-  MPI_Isend(globals.chunk.hm_left_snd_buffer.data(), total_size, MPI_DOUBLE, left_task, tag_send, MPI_COMM_WORLD, &req_send);
+  if (clover_message_neighbour(chunk, message) == external_face) return;
 
-  MPI_Irecv(globals.chunk.hm_left_rcv_buffer.data(), total_size, MPI_DOUBLE, left_task, tag_recv, MPI_COMM_WORLD, &req_recv);
-}
+  clover_claim_buffer(message);
 
-void clover_unpack_left(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int left_right_offset[NUM_FIELDS]) {
-
-  int t_offset = (globals.chunk.tiles[tile].t_bottom - globals.chunk.bottom) * depth;
-
-  if (fields[field_density0] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel0]+t_offset);
-  }
-  if (fields[field_xvel1] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel1]+t_offset);
-  }
-  if (fields[field_yvel0] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel0]+t_offset);
-  }
-  if (fields[field_yvel1] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel1]+t_offset);
-  }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_vol_flux_x]+t_offset);
-  }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_vol_flux_y]+t_offset);
-  }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_mass_flux_x]+t_offset);
+  for (int tile = chunk.first_tile; tile < chunk.first_tile+globals.tiles_per_chunk; ++tile) {
+    if (globals.tiles[tile].external_tile_mask[face] == 1) {
+      clover_pack_tile(globals, tile, message, plan.fields, plan.depth, offset);
+    }
   }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_unpack_message_left(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.left_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_mass_flux_y]+t_offset);
+  if (clover_remote_message(globals, chunk, message)) {
+    Kokkos::deep_copy(clover_host_message_buffer(chunk, message, true), clover_message_buffer(chunk, message, true));
   }
 }
 
-void clover_pack_right(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int left_right_offset[NUM_FIELDS]) {
-
-  int t_offset = (globals.chunk.tiles[tile].t_bottom - globals.chunk.bottom) * depth;
-
-  if (fields[field_density0] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel0]+t_offset);
-  }
-  if (fields[field_xvel1] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel1]+t_offset);
-  }
-  if (fields[field_yvel0] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel0]+t_offset);
-  }
-  if (fields[field_yvel1] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel1]+t_offset);
-  }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_vol_flux_x]+t_offset);
-  }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_vol_flux_y]+t_offset);
-  }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_mass_flux_x]+t_offset);
+// Copies the message across one face of a chunk back to the device if it came
+// from another task, and unpacks it into the tiles along that face
+void clover_unpack_face(global_variables& globals, halo_plan& plan, int message, int face, int offset[NUM_FIELDS]) {
+
+  chunk_type& chunk = globals.chunks[plan.chunk];
+
+  if (clover_message_neighbour(chunk, message) == external_face) return;
+
+  if (clover_remote_message(globals, chunk, message)) {
+    Kokkos::deep_copy(clover_message_buffer(chunk, message, false), clover_host_message_buffer(chunk, message, false));
   }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_pack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.right_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_mass_flux_y]+t_offset);
+
+  for (int tile = chunk.first_tile; tile < chunk.first_tile+globals.tiles_per_chunk; ++tile) {
+    if (globals.tiles[tile].external_tile_mask[face] == 1) {
+      clover_unpack_tile(globals, tile, message, plan.fields, plan.depth, offset);
+    }
   }
 }
 
-void clover_send_recv_message_right(
-  global_variables& globals,
-  Kokkos::View<double*>& right_snd_buffer,
-  Kokkos::View<double*>& right_rcv_buffer,
-  int total_size, int tag_send, int tag_recv,
-  MPI_Request& req_send, MPI_Request& req_recv) {
+// Packs the left and right messages and copies them to the host
+void clover_pack_left_right(global_variables& globals, halo_plan& plan) {
 
-  // First copy send buffer from device to host
-  Kokkos::deep_copy(globals.chunk.hm_right_snd_buffer, right_snd_buffer);
+  clover_pack_face(globals, plan, message_left, tile_left, plan.left_right_offset);
+  clover_pack_face(globals, plan, message_right, tile_right, plan.left_right_offset);
+}
+
+// Unpacks the left and right messages
+void clover_unpack_left_right(global_variables& globals, halo_plan& plan) {
 
-  int right_task = globals.chunk.chunk_neighbours[chunk_right] - 1;
+  clover_unpack_face(globals, plan, message_left, tile_left, plan.left_right_offset);
+  clover_unpack_face(globals, plan, message_right, tile_right, plan.left_right_offset);
+}
 
-  MPI_Isend(globals.chunk.hm_right_snd_buffer.data(), total_size, MPI_DOUBLE, right_task, tag_send, MPI_COMM_WORLD, &req_send);
+// Packs the bottom and top messages and copies them to the host
+void clover_pack_bottom_top(global_variables& globals, halo_plan& plan) {
 
-  MPI_Irecv(globals.chunk.hm_right_rcv_buffer.data(), total_size, MPI_DOUBLE, right_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  clover_pack_face(globals, plan, message_bottom, tile_bottom, plan.bottom_top_offset);
+  clover_pack_face(globals, plan, message_top, tile_top, plan.bottom_top_offset);
 }
 
-void clover_unpack_right(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int left_right_offset[NUM_FIELDS]) {
-
-  int t_offset = (globals.chunk.tiles[tile].t_bottom - globals.chunk.bottom) * depth;
-
-  if (fields[field_density0] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      left_right_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel0]+t_offset);
-  }
-  if (fields[field_xvel1] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_xvel1]+t_offset);
-  }
-  if (fields[field_yvel0] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel0]+t_offset);
-  }
-  if (fields[field_yvel1] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      left_right_offset[field_yvel1]+t_offset);
-  }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_vol_flux_x]+t_offset);
-  }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_vol_flux_y]+t_offset);
-  }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      left_right_offset[field_mass_flux_x]+t_offset);
-  }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_unpack_message_right(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.right_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      left_right_offset[field_mass_flux_y]+t_offset);
-  }
+// Unpacks the bottom and top messages
+void clover_unpack_bottom_top(global_variables& globals, halo_plan& plan) {
+
+  clover_unpack_face(globals, plan, message_top, tile_top, plan.bottom_top_offset);
+  clover_unpack_face(globals, plan, message_bottom, tile_bottom, plan.bottom_top_offset);
 }
 
-void clover_pack_top(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int bottom_top_offset[NUM_FIELDS]) {
-
-  int t_offset = (globals.chunk.tiles[tile].t_left - globals.chunk.left) * depth;
-
-  if (fields[field_density0] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel0]+t_offset);
-  }
-  if (fields[field_xvel1] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel1]+t_offset);
-  }
-  if (fields[field_yvel0] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel0]+t_offset);
-  }
-  if (fields[field_yvel1] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel1]+t_offset);
-  }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_vol_flux_x]+t_offset);
-  }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_vol_flux_y]+t_offset);
-  }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_mass_flux_x]+t_offset);
-  }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_pack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.top_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_mass_flux_y]+t_offset);
+// Packs the corner blocks for the diagonal neighbours and copies them to the
+// host
+void clover_pack_corners(global_variables& globals, halo_plan& plan) {
+
+  chunk_type& chunk = globals.chunks[plan.chunk];
+
+  for (int corner = 0; corner < 4; ++corner) {
+    int tile = clover_corner_tile(globals, chunk, corner);
+    if (tile < 0) continue;
+
+    const int message = message_bottom_left+corner;
+    clover_claim_buffer(message);
+    clover_pack_tile(globals, tile, message, plan.fields, plan.depth, plan.corner_offset);
+    if (clover_remote_message(globals, chunk, message)) {
+      Kokkos::deep_copy(chunk.hm_corner_snd_buffer[corner], chunk.corner_snd_buffer[corner]);
+    }
   }
 }
 
-void clover_send_recv_message_top(
-  global_variables& globals,
-  Kokkos::View<double*>& top_snd_buffer,
-  Kokkos::View<double*>& top_rcv_buffer,
-  int total_size, int tag_send, int tag_recv,
-  MPI_Request& req_send, MPI_Request& req_recv) {
+// Unpacks the diagonal messages. They are unpacked last so that they replace
+// the corner values the edge messages carry, which are stale in a single
+// phase exchange.
+void clover_unpack_corners(global_variables& globals, halo_plan& plan) {
 
-  // First copy send buffer from device to host
-  Kokkos::deep_copy(globals.chunk.hm_top_snd_buffer, top_snd_buffer);
+  chunk_type& chunk = globals.chunks[plan.chunk];
 
-  int top_task = globals.chunk.chunk_neighbours[chunk_top] - 1;
+  for (int corner = 0; corner < 4; ++corner) {
+    int tile = clover_corner_tile(globals, chunk, corner);
+    if (tile < 0) continue;
 
-  MPI_Isend(globals.chunk.hm_top_snd_buffer.data(), total_size, MPI_DOUBLE, top_task, tag_send, MPI_COMM_WORLD, &req_send);
+    const int message = message_bottom_left+corner;
+    if (clover_remote_message(globals, chunk, message)) {
+      Kokkos::deep_copy(chunk.corner_rcv_buffer[corner], chunk.hm_corner_rcv_buffer[corner]);
+    }
+    clover_unpack_tile(globals, tile, message, plan.fields, plan.depth, plan.corner_offset);
+  }
+}
+}
+
+void clover_exchange(global_variables& globals, int fields[NUM_FIELDS], const int depth) {
 
-  MPI_Irecv(globals.chunk.hm_top_rcv_buffer.data(), total_size, MPI_DOUBLE, top_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  clover_exchange_start(globals, fields, depth);
+  clover_exchange_finish(globals);
 }
 
-void clover_unpack_top(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int bottom_top_offset[NUM_FIELDS]) {
-
-  int t_offset = (globals.chunk.tiles[tile].t_left - globals.chunk.left) * depth;
-
-  if (fields[field_density0] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel0]+t_offset);
-  }
-  if (fields[field_xvel1] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel1]+t_offset);
-  }
-  if (fields[field_yvel0] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel0]+t_offset);
-  }
-  if (fields[field_yvel1] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel1]+t_offset);
-  }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_vol_flux_x]+t_offset);
-  }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_vol_flux_y]+t_offset);
-  }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_mass_flux_x]+t_offset);
+// Packs and starts the left and right messages and returns without waiting, so
+// work that does not read the chunk halo can run while they are in flight.
+// With exchange_corners all eight messages are started here. The messages
+// between chunks of the task are only packed, as they are written in place.
+void clover_exchange_start(global_variables& globals, int fields[NUM_FIELDS], const int depth) {
+
+  if (!in_flight.empty()) {
+    report_error((char *)"clover_exchange_start", (char *)"halo exchange already in flight");
   }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_unpack_message_top(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.top_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_mass_flux_y]+t_offset);
+
+  for (int c = 0; c < globals.local_chunks; ++c) {
+    halo_plan& plan = clover_halo_plan(globals, c, fields, depth);
+    in_flight.push_back(&plan);
+
+    clover_pack_left_right(globals, plan);
+
+    if (plan.corners) {
+      clover_pack_bottom_top(globals, plan);
+      clover_pack_corners(globals, plan);
+    }
+
+    clover_sync_written();
+
+    if (plan.collective) {
+      chunk_type& chunk = globals.chunks[c];
+      MPI_Ineighbor_alltoallv(chunk.hm_snd_arena.data(), plan.first_counts, plan.displacements, MPI_DOUBLE,
+        chunk.hm_rcv_arena.data(), plan.first_counts, plan.displacements, MPI_DOUBLE, plan.comm, &plan.collective_request);
+    }
+    else if (plan.first_count > 0) {
+      MPI_Startall(plan.first_count, plan.first);
+    }
   }
 }
 
-void clover_pack_bottom(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int bottom_top_offset[NUM_FIELDS]) {
-
-  int t_offset = (globals.chunk.tiles[tile].t_left - globals.chunk.left) * depth;
-
-  if (fields[field_density0] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel0]+t_offset);
+// Completes the exchange started by clover_exchange_start. In the two phase
+// exchange it unpacks the left and right messages and then does the bottom and
+// top exchange, which carries the corners and so has to follow them. In the
+// single phase exchange all messages are already started, so it makes one wait.
+// Each phase is packed for every chunk of the task before any is unpacked, so
+// the messages between them are complete.
+void clover_exchange_finish(global_variables& globals) {
+
+  if (in_flight.empty()) {
+    report_error((char *)"clover_exchange_finish", (char *)"no halo exchange in flight");
   }
-  if (fields[field_xvel1] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel1]+t_offset);
+
+  // make a call to wait / sync
+  for (size_t c = 0; c < in_flight.size(); ++c) {
+    halo_plan& plan = *in_flight[c];
+    if (plan.collective) {
+      MPI_Wait(&plan.collective_request, MPI_STATUS_IGNORE);
+    }
+    else {
+      MPI_Waitall(plan.first_count, plan.first, MPI_STATUSES_IGNORE);
+    }
   }
-  if (fields[field_yvel0] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel0]+t_offset);
+  if (shared_window != MPI_WIN_NULL) MPI_Win_sync(shared_window);
+
+  for (size_t c = 0; c < in_flight.size(); ++c) {
+    halo_plan& plan = *in_flight[c];
+    clover_unpack_left_right(globals, plan);
+
+    if (plan.corners) {
+      clover_unpack_bottom_top(globals, plan);
+      clover_unpack_corners(globals, plan);
+    }
   }
-  if (fields[field_yvel1] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel1]+t_offset);
+
+  if (!in_flight[0]->corners) {
+    for (size_t c = 0; c < in_flight.size(); ++c) {
+      halo_plan& plan = *in_flight[c];
+      clover_pack_bottom_top(globals, plan);
+      clover_sync_written();
+      if (plan.collective) {
+        chunk_type& chunk = globals.chunks[plan.chunk];
+        MPI_Neighbor_alltoallv(chunk.hm_snd_arena.data(), plan.second_counts, plan.displacements, MPI_DOUBLE,
+          chunk.hm_rcv_arena.data(), plan.second_counts, plan.displacements, MPI_DOUBLE, plan.comm);
+      }
+      else if (plan.second_count > 0) {
+        MPI_Startall(plan.second_count, plan.second);
+      }
+    }
+
+    // need to make a call to wait / sync
+    for (size_t c = 0; c < in_flight.size(); ++c) {
+      halo_plan& plan = *in_flight[c];
+      if (!plan.collective) MPI_Waitall(plan.second_count, plan.second, MPI_STATUSES_IGNORE);
+    }
+    if (shared_window != MPI_WIN_NULL) MPI_Win_sync(shared_window);
+
+    for (size_t c = 0; c < in_flight.size(); ++c) {
+      clover_unpack_bottom_top(globals, *in_flight[c]);
+    }
   }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_vol_flux_x]+t_offset);
+
+  for (size_t c = 0; c < in_flight.size(); ++c) {
+    clover_release_buffers(*in_flight[c]);
   }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_vol_flux_y]+t_offset);
+
+  in_flight.clear();
+}
+
+// Releases the halo plans and the shared window, whose requests and memory
+// are tied to the buffers, so that clover_allocate_buffers can size them anew
+void clover_free_buffers() {
+
+  for (std::map<long, halo_plan>::iterator it = halo_plans.begin(); it != halo_plans.end(); ++it) {
+    for (int i = 0; i < it->second.first_count; ++i) MPI_Request_free(&it->second.first[i]);
+    for (int i = 0; i < it->second.second_count; ++i) MPI_Request_free(&it->second.second[i]);
   }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_mass_flux_x]+t_offset);
+  halo_plans.clear();
+
+  for (int message = 0; message < 8; ++message) {
+    if (!shared_message[message]) continue;
+    if (free_send_pending[message]) MPI_Wait(&free_send[message], MPI_STATUS_IGNORE);
+    if (free_recv_pending[message]) MPI_Wait(&free_recv[message], MPI_STATUS_IGNORE);
+    MPI_Request_free(&free_send[message]);
+    MPI_Request_free(&free_recv[message]);
+    free_send_pending[message] = false;
+    free_recv_pending[message] = false;
+    shared_message[message] = false;
   }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_pack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.bottom_snd_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_mass_flux_y]+t_offset);
+  if (shared_window != MPI_WIN_NULL) {
+    MPI_Win_unlock_all(shared_window);
+    MPI_Win_free(&shared_window);
   }
+  if (node_comm != MPI_COMM_NULL) MPI_Comm_free(&node_comm);
 }
 
-void clover_send_recv_message_bottom(
-  global_variables& globals,
-  Kokkos::View<double*>& bottom_snd_buffer,
-  Kokkos::View<double*>& bottom_rcv_buffer,
-  int total_size, int tag_send, int tag_recv,
-  MPI_Request& req_send, MPI_Request& req_recv) {
+// Releases the persistent requests of every halo plan and the communicators
+// and shared window they use
+void clover_free_halo_plans() {
 
-  // First copy send buffer from device to host
-  Kokkos::deep_copy(globals.chunk.hm_bottom_snd_buffer, bottom_snd_buffer);
+  clover_free_buffers();
 
-  int bottom_task = globals.chunk.chunk_neighbours[chunk_bottom] - 1;
+  if (corner_comm != MPI_COMM_NULL) MPI_Comm_free(&corner_comm);
+  if (halo_comm != MPI_COMM_WORLD) MPI_Comm_free(&halo_comm);
+  halo_comm = MPI_COMM_WORLD;
+}
 
-  MPI_Isend(globals.chunk.hm_bottom_snd_buffer.data(), total_size, MPI_DOUBLE, bottom_task, tag_send, MPI_COMM_WORLD, &req_send);
 
-  MPI_Irecv(globals.chunk.hm_bottom_rcv_buffer.data(), total_size, MPI_DOUBLE, bottom_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+// Collects the requested fields of a tile with their offsets into a message
+// buffer. The work fields get their own list when they are stored in a
+// different precision.
+void clover_message_lists(field_type& field, int fields[NUM_FIELDS], int offset[NUM_FIELDS], int t_offset,
+  pack_list<field_view>& list, pack_list<work_view>& work_list) {
+
+#if defined(CLOVER_MIXED_PRECISION)
+  pack_list<work_view>& cell_work_list = work_list;
+#else
+  pack_list<field_view>& cell_work_list = list;
+#endif
+
+  if (fields[field_density0] == 1)    list.add(field.density0,              cell_data,   offset[field_density0]+t_offset);
+  if (fields[field_density1] == 1)    list.add(field.density1,              cell_data,   offset[field_density1]+t_offset);
+  if (fields[field_energy0] == 1)     list.add(field.energy0,               cell_data,   offset[field_energy0]+t_offset);
+  if (fields[field_energy1] == 1)     list.add(field.energy1,               cell_data,   offset[field_energy1]+t_offset);
+  if (fields[field_pressure] == 1)    list.add(field.pressure,              cell_data,   offset[field_pressure]+t_offset);
+  if (fields[field_viscosity] == 1)   cell_work_list.add(field.viscosity,   cell_data,   offset[field_viscosity]+t_offset);
+  if (fields[field_soundspeed] == 1)  cell_work_list.add(field.soundspeed,  cell_data,   offset[field_soundspeed]+t_offset);
+  if (fields[field_xvel0] == 1)       list.add(field.xvel0,                 vertex_data, offset[field_xvel0]+t_offset);
+  if (fields[field_xvel1] == 1)       list.add(field.xvel1,                 vertex_data, offset[field_xvel1]+t_offset);
+  if (fields[field_yvel0] == 1)       list.add(field.yvel0,                 vertex_data, offset[field_yvel0]+t_offset);
+  if (fields[field_yvel1] == 1)       list.add(field.yvel1,                 vertex_data, offset[field_yvel1]+t_offset);
+  if (fields[field_vol_flux_x] == 1)  list.add(field.vol_flux_x,            x_face_data, offset[field_vol_flux_x]+t_offset);
+  if (fields[field_vol_flux_y] == 1)  list.add(field.vol_flux_y,            y_face_data, offset[field_vol_flux_y]+t_offset);
+  if (fields[field_mass_flux_x] == 1) list.add(field.mass_flux_x,           x_face_data, offset[field_mass_flux_x]+t_offset);
+  if (fields[field_mass_flux_y] == 1) list.add(field.mass_flux_y,           y_face_data, offset[field_mass_flux_y]+t_offset);
 }
 
-void clover_unpack_bottom(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int bottom_top_offset[NUM_FIELDS]) {
-
-  int t_offset = (globals.chunk.tiles[tile].t_left - globals.chunk.left) * depth;
-
-  if (fields[field_density0] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density0]+t_offset);
-  }
-  if (fields[field_density1] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_density1]+t_offset);
-  }
-  if (fields[field_energy0] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy0]+t_offset);
-  }
-  if (fields[field_energy1] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_energy1]+t_offset);
-  }
-  if (fields[field_pressure] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_pressure]+t_offset);
-  }
-  if (fields[field_viscosity] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.viscosity,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_viscosity]+t_offset);
-  }
-  if (fields[field_soundspeed] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.soundspeed,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, cell_data,
-      bottom_top_offset[field_soundspeed]+t_offset);
-  }
-  if (fields[field_xvel0] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel0]+t_offset);
-  }
-  if (fields[field_xvel1] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_xvel1]+t_offset);
-  }
-  if (fields[field_yvel0] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel0]+t_offset);
-  }
-  if (fields[field_yvel1] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, vertex_data,
-      bottom_top_offset[field_yvel1]+t_offset);
-  }
-  if (fields[field_vol_flux_x] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_vol_flux_x]+t_offset);
+// Offset of a tile's part of a message: edge strips are laid out along the
+// chunk edge, corner blocks come from a single tile
+int clover_message_tile_offset(global_variables& globals, int tile, int message, int depth) {
+
+  tile_type& t = globals.tiles[tile];
+
+  if (message == message_left || message == message_right) {
+    return (t.t_bottom - globals.chunks[t.chunk].bottom) * depth;
   }
-  if (fields[field_vol_flux_y] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.vol_flux_y,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_vol_flux_y]+t_offset);
+  if (message == message_bottom || message == message_top) {
+    return (t.t_left - globals.chunks[t.chunk].left) * depth;
   }
-  if (fields[field_mass_flux_x] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_x,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, x_face_data,
-      bottom_top_offset[field_mass_flux_x]+t_offset);
+  return 0;
+}
+
+Kokkos::View<double*>& clover_message_buffer(chunk_type& chunk, int message, bool send) {
+
+  switch (message) {
+    case message_left:   return send ? chunk.left_snd_buffer   : chunk.left_rcv_buffer;
+    case message_right:  return send ? chunk.right_snd_buffer  : chunk.right_rcv_buffer;
+    case message_bottom: return send ? chunk.bottom_snd_buffer : chunk.bottom_rcv_buffer;
+    case message_top:    return send ? chunk.top_snd_buffer    : chunk.top_rcv_buffer;
   }
-  if (fields[field_mass_flux_y] == 1) {
-    clover_unpack_message_bottom(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.mass_flux_y,
-      globals.chunk.bottom_rcv_buffer,
-      cell_data, vertex_data, x_face_data, y_face_data,
-      depth, y_face_data,
-      bottom_top_offset[field_mass_flux_y]+t_offset);
+  const int corner = message - message_bottom_left;
+  return send ? chunk.corner_snd_buffer[corner] : chunk.corner_rcv_buffer[corner];
+}
+
+// The host mirror of the buffer a message is sent from or received into
+Kokkos::View<double*>::HostMirror& clover_host_message_buffer(chunk_type& chunk, int message, bool send) {
+
+  switch (message) {
+    case message_left:   return send ? chunk.hm_left_snd_buffer   : chunk.hm_left_rcv_buffer;
+    case message_right:  return send ? chunk.hm_right_snd_buffer  : chunk.hm_right_rcv_buffer;
+    case message_bottom: return send ? chunk.hm_bottom_snd_buffer : chunk.hm_bottom_rcv_buffer;
+    case message_top:    return send ? chunk.hm_top_snd_buffer    : chunk.hm_top_rcv_buffer;
   }
+  const int corner = message - message_bottom_left;
+  return send ? chunk.hm_corner_snd_buffer[corner] : chunk.hm_corner_rcv_buffer[corner];
+}
+
+void clover_pack_tile(global_variables& globals, int tile, int message, int fields[NUM_FIELDS], int depth, int offset[NUM_FIELDS]) {
+
+  pack_list<field_view> list;
+  pack_list<work_view> work_list;
+  clover_message_lists(globals.tiles[tile].field, fields, offset,
+    clover_message_tile_offset(globals, tile, message, depth), list, work_list);
+
+  Kokkos::View<double*>& buffer = clover_message_buffer(globals.chunks[globals.tiles[tile].chunk], message, true);
+
+  clover_pack_message(message,
+    globals.tiles[tile].t_xmin,
+    globals.tiles[tile].t_xmax,
+    globals.tiles[tile].t_ymin,
+    globals.tiles[tile].t_ymax,
+    list, buffer, depth);
+#if defined(CLOVER_MIXED_PRECISION)
+  clover_pack_message(message,
+    globals.tiles[tile].t_xmin,
+    globals.tiles[tile].t_xmax,
+    globals.tiles[tile].t_ymin,
+    globals.tiles[tile].t_ymax,
+    work_list, buffer, depth);
+#endif
+}
+
+void clover_unpack_tile(global_variables& globals, int tile, int message, int fields[NUM_FIELDS], int depth, int offset[NUM_FIELDS]) {
+
+  pack_list<field_view> list;
+  pack_list<work_view> work_list;
+  clover_message_lists(globals.tiles[tile].field, fields, offset,
+    clover_message_tile_offset(globals, tile, message, depth), list, work_list);
+
+  Kokkos::View<double*>& buffer = clover_message_buffer(globals.chunks[globals.tiles[tile].chunk], message, false);
+
+  clover_unpack_message(message,
+    globals.tiles[tile].t_xmin,
+    globals.tiles[tile].t_xmax,
+    globals.tiles[tile].t_ymin,
+    globals.tiles[tile].t_ymax,
+    list, buffer, depth);
+#if defined(CLOVER_MIXED_PRECISION)
+  clover_unpack_message(message,
+    globals.tiles[tile].t_xmin,
+    globals.tiles[tile].t_xmax,
+    globals.tiles[tile].t_ymin,
+    globals.tiles[tile].t_ymax,
+    work_list, buffer, depth);
+#endif
 }
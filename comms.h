@@ -50,31 +50,36 @@ struct parallel_ {
 void clover_abort();
 void clover_barrier();
 
-void clover_decompose(global_variables& globals, parallel_& parallel, int x_cells, int y_cells, int& left, int& right, int& bottom, int& top);
-void clover_tile_decompose(global_variables& globals, int chunk_x_cells, int chunk_y_cells);
+void clover_decompose(global_variables& globals, parallel_& parallel, int x_cells, int y_cells);
+void clover_tile_split(global_variables& globals, int chunk, int& tile_x, int& tile_y);
+void clover_tile_decompose(global_variables& globals, int chunk);
 void clover_allocate_buffers(global_variables& globals, parallel_& parallel);
 
+// Most values combined in one reduction
+#define MAX_REDUCTION 8
+
 void clover_sum(double& value);
+void clover_sum(double *values, int count);
 void clover_min(double& value);
+void clover_min(double& value, int& task);
+void clover_min_start(double& value);
+void clover_min_finish(double& value, int& task);
+void clover_broadcast(double *values, int count, int root);
 void clover_allgather(double value, double *values);
+void clover_gather(double *values, int count, double *gathered);
+void clover_allgather(double *values, int count, double *gathered);
+void clover_alltoallv(double *values, int *counts, int *displacements,
+  double *received, int *received_counts, int *received_displacements);
 void clover_check_error(int& error);
 
 void clover_exchange(global_variables& globals, int fields[NUM_FIELDS], const int depth);
+void clover_exchange_start(global_variables& globals, int fields[NUM_FIELDS], const int depth);
+void clover_exchange_finish(global_variables& globals);
+void clover_free_buffers();
+void clover_free_halo_plans();
 
-void clover_pack_left(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int left_right_offset[NUM_FIELDS]);
-void clover_send_recv_message_left(global_variables& globals, Kokkos::View<double*>& left_snd_buffer, Kokkos::View<double*>& left_rcv_buffer, int total_size, int tag_send, int tag_recv, MPI_Request& req_send, MPI_Request& req_recv);
-void clover_unpack_left(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int left_right_offset[NUM_FIELDS]);
-
-void clover_pack_right(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int left_right_offset[NUM_FIELDS]);
-void clover_send_recv_message_right(global_variables& globals, Kokkos::View<double*>& right_snd_buffer, Kokkos::View<double*>& right_rcv_buffer, int total_size, int tag_send, int tag_recv, MPI_Request& req_send, MPI_Request& req_recv);
-void clover_unpack_right(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int left_right_offset[NUM_FIELDS]);
-
-void clover_pack_top(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int bottom_top_offset[NUM_FIELDS]);
-void clover_send_recv_message_top(global_variables& globals, Kokkos::View<double*>& top_snd_buffer, Kokkos::View<double*>& top_rcv_buffer, int total_size, int tag_send, int tag_recv, MPI_Request& req_send, MPI_Request& req_recv);
-void clover_unpack_top(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int bottom_top_offset[NUM_FIELDS]);
+void clover_pack_tile(global_variables& globals, int tile, int message, int fields[NUM_FIELDS], int depth, int offset[NUM_FIELDS]);
+void clover_unpack_tile(global_variables& globals, int tile, int message, int fields[NUM_FIELDS], int depth, int offset[NUM_FIELDS]);
 
-void clover_pack_bottom(global_variables& globals, int tile, int fields[NUM_FIELDS], int depth, int bottom_top_offset[NUM_FIELDS]);
-void clover_send_recv_message_bottom(global_variables& globals, Kokkos::View<double*>& bottom_snd_buffer, Kokkos::View<double*>& top_rcv_buffer, int total_size, int tag_send, int tag_recv, MPI_Request& req_send, MPI_Request& req_recv);
-void clover_unpack_bottom(global_variables& globals, int fields[NUM_FIELDS], int tile, int depth, int bottom_top_offset[NUM_FIELDS]);
 #endif
 
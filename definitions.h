@@ -26,17 +26,55 @@
 #define g_small (1.0e-16)
 #define g_big   (1.0e+21)
 #define NUM_FIELDS 15
+// Values read back for the cell controlling the timestep: x, y, the four
+// corner velocities, density, energy, pressure and soundspeed
+#define NUM_DT_CELL 14
 
 // Cannot call std::min or std::max from a CUDA kernel, so use these macros instead.
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) >= (b)) ? (a) : (b))
 
+// Memory layout of the 2D fields, chosen at build time with CLOVER_LAYOUT_LEFT
+// (j contiguous, as in the Fortran) or CLOVER_LAYOUT_RIGHT (k contiguous).
+// Otherwise the default layout of the execution space is used. The 2D loops
+// iterate with the contiguous index innermost to match.
+#if defined(CLOVER_LAYOUT_LEFT)
+typedef Kokkos::LayoutLeft field_layout;
+typedef Kokkos::MDRangePolicy<Kokkos::Rank<2, Kokkos::Iterate::Left, Kokkos::Iterate::Left>> field_policy;
+#elif defined(CLOVER_LAYOUT_RIGHT)
+typedef Kokkos::LayoutRight field_layout;
+typedef Kokkos::MDRangePolicy<Kokkos::Rank<2, Kokkos::Iterate::Right, Kokkos::Iterate::Right>> field_policy;
+#else
+typedef Kokkos::DefaultExecutionSpace::array_layout field_layout;
+typedef Kokkos::MDRangePolicy<Kokkos::Rank<2>> field_policy;
+#endif
+
+typedef Kokkos::View<double**, field_layout> field_view;
+
+// Execution space the kernels run in. Each tile launches its kernels on an
+// instance of it, so that tiles on different instances can run concurrently.
+typedef Kokkos::DefaultExecutionSpace exec_space;
+
+// Storage of the fields that are recomputed every step and never conserved:
+// the soundspeed, the viscosity and the scratch temporaries. Building with
+// CLOVER_MIXED_PRECISION stores them in float, halving their memory traffic.
+// They are still computed in double, as are the conserved fields and every
+// reduction.
+#if defined(CLOVER_MIXED_PRECISION)
+typedef float work_type;
+#else
+typedef double work_type;
+#endif
+
+typedef Kokkos::View<work_type**, field_layout> work_view;
+
 
 enum geometry_type { g_rect = 1, g_circ = 2, g_point = 3 };
 
 // In the Fortran version these are 1,2,3,4,-1, but they are used firectly to index an array in this version
 enum chunk_neighbour_type { chunk_left = 0, chunk_right = 1, chunk_bottom = 2, chunk_top = 3, external_face = -1 };
-enum tile_neighbour_type { tile_left = 0, tile_right = 1, tile_bottom = 3, tile_top = 3, external_tile = -1 };
+enum chunk_corner_type { corner_bottom_left = 0, corner_bottom_right = 1, corner_top_left = 2, corner_top_right = 3 };
+enum tile_neighbour_type { tile_left = 0, tile_right = 1, tile_bottom = 2, tile_top = 3, external_tile = -1 };
 
 // Again, start at 0 as used for indexing an array of length NUM_FIELDS
 enum field_parameter {
@@ -58,6 +96,22 @@ enum field_parameter {
   field_mass_flux_y= 14
 };
 
+// Full-size temporaries used within a phase of the step, mapped onto shared
+// buffers by scratch_plan()
+enum scratch_name {
+  scratch_cell_pre_vol   = 0,
+  scratch_cell_post_vol  = 1,
+  scratch_ener_flux      = 2,
+  scratch_node_flux      = 3,
+  scratch_node_mass_post = 4,
+  scratch_node_mass_pre  = 5,
+  scratch_mom_flux       = 6,
+  scratch_ymom_flux      = 7,
+  scratch_mom_pre_vol    = 8,
+  scratch_mom_post_vol   = 9,
+  NUM_SCRATCH            = 10
+};
+
 enum data_parameter {
   cell_data = 1,
   vertex_data = 2,
@@ -69,6 +123,21 @@ enum dir_parameter {
   g_xdir = 1, g_ydir = 2
 };
 
+// Part of a kernel to run when overlapping it with a halo exchange. The
+// interior reads no chunk halo cells and can run while the exchange is in
+// flight; the boundary completes the kernel once the exchange has finished.
+enum overlap_part {
+  overlap_all = 0, overlap_interior = 1, overlap_boundary = 2
+};
+
+// Element of a 2D field offset along the direction of an advection sweep. The
+// index i replaces j in an x sweep and k in a y sweep.
+template <int dir, class view_type>
+KOKKOS_INLINE_FUNCTION
+typename view_type::value_type& advec_along(const view_type& v, const int j, const int k, const int i) {
+  return (dir == g_xdir) ? v(i,k) : v(j,i);
+}
+
 struct state_type {
 
   bool defined;
@@ -102,6 +171,7 @@ struct grid_type {
 struct profiler_type {
 
   double timestep;
+  double timestep_reduction;
   double acceleration;
   double PdV;
   double cell_advection;
@@ -120,25 +190,20 @@ struct profiler_type {
 
 struct field_type {
 
-  Kokkos::View<double**> density0;
-  Kokkos::View<double**> density1;
-  Kokkos::View<double**> energy0;
-  Kokkos::View<double**> energy1;
-  Kokkos::View<double**> pressure;
-  Kokkos::View<double**> viscosity;
-  Kokkos::View<double**> soundspeed;
-  Kokkos::View<double**> xvel0, xvel1;
-  Kokkos::View<double**> yvel0, yvel1;
-  Kokkos::View<double**> vol_flux_x, mass_flux_x;
-  Kokkos::View<double**> vol_flux_y, mass_flux_y;
-
-  Kokkos::View<double**> work_array1; // node_flux, stepbymass, volume_change, pre_vol
-  Kokkos::View<double**> work_array2; // node_mass_post, post_vol
-  Kokkos::View<double**> work_array3; // node_mass_pre,pre_mass
-  Kokkos::View<double**> work_array4; // advec_vel, post_mass
-  Kokkos::View<double**> work_array5; // mom_flux, advec_vol
-  Kokkos::View<double**> work_array6; // pre_vol, post_ener
-  Kokkos::View<double**> work_array7; // post_vol, ener_flux
+  field_view density0;
+  field_view density1;
+  field_view energy0;
+  field_view energy1;
+  field_view pressure;
+  work_view viscosity;
+  work_view soundspeed;
+  field_view xvel0, xvel1;
+  field_view yvel0, yvel1;
+  field_view vol_flux_x, mass_flux_x;
+  field_view vol_flux_y, mass_flux_y;
+
+  // Shared temporaries, only the first scratch_count are allocated
+  work_view scratch[NUM_SCRATCH];
 
   Kokkos::View<double*> cellx;
   Kokkos::View<double*> celly;
@@ -149,15 +214,21 @@ struct field_type {
   Kokkos::View<double*> vertexdx;
   Kokkos::View<double*> vertexdy;
 
-  Kokkos::View<double**> volume;
-  Kokkos::View<double**> xarea;
-  Kokkos::View<double**> yarea;
+  field_view volume;
+  field_view xarea;
+  field_view yarea;
+
+  // Values of the cell controlling the timestep and their host copy, kept
+  // from step to step so that reading them back allocates nothing
+  Kokkos::View<double*> dt_cell;
+  typename Kokkos::View<double*>::HostMirror hm_dt_cell;
 
 };
 
 struct tile_type {
 
   field_type field;
+  size_t field_bytes; // Footprint of the fields in the chunk field arena
   int tile_neighbours[4];
   int external_tile_mask[4];
 
@@ -165,13 +236,26 @@ struct tile_type {
 
   int t_left, t_right, t_bottom, t_top;
 
+  int chunk; // Index in globals.chunks of the chunk holding the tile
+  exec_space space; // Instance the hydro kernels of the tile are launched on
+
 };
 
 struct chunk_type {
 
   int task; // MPI task
+  int number; // Position in the chunk grid, counted from 1 along x first
+
+  int chunk_neighbours[4]; // Chunk numbers, not tasks, as a task may hold several chunks
+  int corner_neighbours[4]; // Diagonal chunks, indexed by chunk_corner_type
+
+  // Single allocation holding the fields of every tile
+  Kokkos::View<double*> field_arena;
 
-  int chunk_neighbours[4]; // Chunks, not tasks, so we can overload in the future
+  // Every send and every receive buffer is carved out of one of these, so
+  // that a neighbourhood collective can address them from a single base
+  Kokkos::View<double*> snd_arena, rcv_arena;
+  typename Kokkos::View<double*>::HostMirror hm_snd_arena, hm_rcv_arena;
 
   // MPI Buffers in device memory
   Kokkos::View<double*> left_rcv_buffer, right_rcv_buffer, bottom_rcv_buffer, top_rcv_buffer;
@@ -181,7 +265,11 @@ struct chunk_type {
   typename Kokkos::View<double*>::HostMirror hm_left_rcv_buffer, hm_right_rcv_buffer, hm_bottom_rcv_buffer, hm_top_rcv_buffer;
   typename Kokkos::View<double*>::HostMirror hm_left_snd_buffer, hm_right_snd_buffer, hm_bottom_snd_buffer, hm_top_snd_buffer;
 
-  tile_type *tiles;
+  // Diagonal MPI buffers for the single phase exchange, indexed by chunk_corner_type
+  Kokkos::View<double*> corner_rcv_buffer[4], corner_snd_buffer[4];
+  typename Kokkos::View<double*>::HostMirror hm_corner_rcv_buffer[4], hm_corner_snd_buffer[4];
+
+  int first_tile; // Index in globals.tiles of the first of the chunk's tiles
 
   int x_min;
   int y_min;
@@ -205,6 +293,30 @@ struct global_variables {
   bool advect_x;
 
   int tiles_per_chunk;
+  int tile_concurrency; // Execution space instances the tiles are spread over
+  size_t tile_cache_bytes; // Cache each tile is sized to fit, 0 to use tiles_per_chunk
+
+  int field_padding; // Doubles of padding after each field in the field arena
+
+  int scratch_count; // Scratch buffers allocated per tile
+  int scratch_map[NUM_SCRATCH]; // Buffer holding each temporary, -1 if unused
+
+  bool fused_timestep; // Equation of state, viscosity and timestep in two passes
+  bool fused_advec_cell; // Cell advection without the pre_vol/post_vol pass
+  bool fused_advec_mom; // Both velocity components advected together
+
+  bool overlap_halo; // Interior work runs while halo messages are in flight
+  bool exchange_corners; // Halo exchange with all eight neighbours in one phase
+  int halo_depth; // Halo cells allocated around each tile, at least 2
+  bool cartesian_topology; // Halo messages on a Cartesian communicator that MPI may reorder
+  bool neighbour_exchange; // Halo exchange by neighbourhood collectives on that communicator
+  bool shared_exchange; // Halo messages to tasks on the same node go through shared memory
+  bool nonblocking_reductions; // The timestep reduction overlaps the viscosity exchange
+  bool temporal_blocking; // Each tile runs from PdV to the advection after one exchange per step
+
+#if defined(CLOVER_MIXED_PRECISION)
+  double summary_mass0, summary_energy0; // Totals at the initial field summary
+#endif
 
   int error_condition;
 
@@ -237,11 +349,17 @@ struct global_variables {
 
   int visit_frequency;
   int summary_frequency;
+  int balance_frequency; // Steps between checks of the load balance, 0 for never
+  double balance_tolerance; // Compute imbalance, over the mean, that moves the chunk boundaries
 
   int jdt, kdt;
 
-  chunk_type chunk;
+  chunk_type *chunks; // The chunks held by this task
+  int local_chunks; // Length of chunks
+  tile_type *tiles; // The tiles of those chunks, chunk by chunk
+  int local_tiles; // Length of tiles
   int number_of_chunks;
+  int *chunk_task; // Task holding each chunk, by chunk number less one
 
   grid_type grid;
 
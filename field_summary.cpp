@@ -19,7 +19,8 @@
 
 
 #include "field_summary.h"
-#include "timer.h"
+#include "profiler.h"
+#include "tile_schedule.h"
 #include "ideal_gas.h"
 
 #include <iomanip>
@@ -41,22 +42,22 @@ struct field_summary_functor {
 
   // Functor data member (kernel arguments)
   int x_min, x_max, y_min, y_max;
-  Kokkos::View<double**> volume;
-  Kokkos::View<double**> density0;
-  Kokkos::View<double**> energy0;
-  Kokkos::View<double**> pressure;
-  Kokkos::View<double**> xvel0;
-  Kokkos::View<double**> yvel0;
+  field_view volume;
+  field_view density0;
+  field_view energy0;
+  field_view pressure;
+  field_view xvel0;
+  field_view yvel0;
 
   // Constructor, which saves the kernel arguments
   field_summary_functor(
     int x_min_, int x_max_, int y_min_, int y_max_,
-    Kokkos::View<double**> volume_,
-    Kokkos::View<double**> density0_,
-    Kokkos::View<double**> energy0_,
-    Kokkos::View<double**> pressure_,
-    Kokkos::View<double**> xvel0_,
-    Kokkos::View<double**> yvel0) :
+    field_view volume_,
+    field_view density0_,
+    field_view energy0_,
+    field_view pressure_,
+    field_view xvel0_,
+    field_view yvel0) :
 
     x_min(x_min_), x_max(x_max_), y_min(y_min_), y_max(y_max_),
     volume(volume_),
@@ -154,17 +155,18 @@ void field_summary(global_variables& globals, parallel_ &parallel) {
       << "Total Energy    " << std::endl;
   }
 
-  double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
+  double kernel_time = profiler_start(globals, "ideal_gas");
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    ideal_gas(globals, tile, false, 0);
   }
 
-  if (globals.profiler_on) {
-    globals.profiler.ideal_gas += timer()-kernel_time;
-    kernel_time = timer();
-  }
+  profiler_stop(globals, globals.profiler.ideal_gas, kernel_time);
+
+  // The summary reduces the tiles on the default instance
+  tile_fence(globals);
+
+  kernel_time = profiler_start(globals, "summary");
 
   double vol = 0.0;
   double mass = 0.0;
@@ -172,40 +174,43 @@ void field_summary(global_variables& globals, parallel_ &parallel) {
   double ke = 0.0;
   double press = 0.0;
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
     field_summary_functor functor(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.volume,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.tiles[tile].field.yvel0);
+      globals.tiles[tile].t_xmin,
+      globals.tiles[tile].t_xmax,
+      globals.tiles[tile].t_ymin,
+      globals.tiles[tile].t_ymax,
+      globals.tiles[tile].field.volume,
+      globals.tiles[tile].field.density0,
+      globals.tiles[tile].field.energy0,
+      globals.tiles[tile].field.pressure,
+      globals.tiles[tile].field.xvel0,
+      globals.tiles[tile].field.yvel0);
 
     typename field_summary_functor::value_type result;
 
     // Use a 1D parallel for because 2D reduction results in shared memory segfaults on a GPU
     Kokkos::parallel_reduce("field_summary",
-      (globals.chunk.tiles[tile].t_ymax-globals.chunk.tiles[tile].t_ymin+1)*
-      (globals.chunk.tiles[tile].t_xmax-globals.chunk.tiles[tile].t_xmin+1), functor, result);
-
-    vol = result.vol;
-    mass = result.mass;
-    ie = result.ie;
-    ke = result.ke;
-    press = result.press;
+      (globals.tiles[tile].t_ymax-globals.tiles[tile].t_ymin+1)*
+      (globals.tiles[tile].t_xmax-globals.tiles[tile].t_xmin+1), functor, result);
+
+    vol += result.vol;
+    mass += result.mass;
+    ie += result.ie;
+    ke += result.ke;
+    press += result.press;
   }
 
-  clover_sum(vol);
-  clover_sum(mass);
-  clover_sum(ie);
-  clover_sum(ke);
-  clover_sum(press);
+  // One reduction for all of the totals
+  double totals[5] = {vol, mass, ie, ke, press};
+  clover_sum(totals, 5);
+  vol = totals[0];
+  mass = totals[1];
+  ie = totals[2];
+  ke = totals[3];
+  press = totals[4];
 
-  if (globals.profiler_on) globals.profiler.summary += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.summary, kernel_time);
 
   if (parallel.boss) {
     auto formatting = g_out.flags();
@@ -222,6 +227,24 @@ void field_summary(global_variables& globals, parallel_ &parallel) {
      g_out.flags(formatting);
   }
 
+#if defined(CLOVER_MIXED_PRECISION)
+  // The mass and total energy are conserved, so their relative change since
+  // the initial summary measures the accumulated error of the reduced
+  // precision storage (see work_type). A double build keeps its output as is
+  if (globals.step == 0) {
+    globals.summary_mass0 = mass;
+    globals.summary_energy0 = ie+ke;
+  }
+  else if (parallel.boss) {
+    auto formatting = g_out.flags();
+    g_out
+      << " drift: mass " << std::scientific << std::setw(15) << (mass-globals.summary_mass0)/globals.summary_mass0
+      << " total energy " << std::scientific << std::setw(15) << (ie+ke-globals.summary_energy0)/globals.summary_energy0
+      << std::endl << std::endl;
+    g_out.flags(formatting);
+  }
+#endif
+
   if (globals.complete) {
     double qa_diff;
     if (parallel.boss) {
@@ -19,27 +19,29 @@
 
 
 #include "flux_calc.h"
-#include "timer.h"
+#include "profiler.h"
+#include "update_halo.h"
 
 
 //  @brief Fortran flux kernel.
 //  @author Wayne Gaudin
 //  @details The edge volume fluxes are calculated based on the velocity fields.
 void flux_calc_kernel(
+  const exec_space& space,
   int x_min, int x_max, int y_min, int y_max,
   double dt,
-  Kokkos::View<double**>& xarea,
-  Kokkos::View<double**>& yarea,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel1,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& vol_flux_y) {
+  field_view& xarea,
+  field_view& yarea,
+  field_view& xvel0,
+  field_view& yvel0,
+  field_view& xvel1,
+  field_view& yvel1,
+  field_view& vol_flux_x,
+  field_view& vol_flux_y) {
 
   // DO k=y_min,y_max+1
   //   DO j=x_min,x_max+1
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min+1, y_min+1}, {x_max+1+2, y_max+1+2});
+  field_policy policy(space, {x_min+1, y_min+1}, {x_max+1+2, y_max+1+2});
 
   // Note that the loops calculate one extra flux than required, but this
   // allows loop fusion that improves performance
@@ -54,35 +56,45 @@ void flux_calc_kernel(
 
 }
 
+//  @brief Flux of one tile.
+//  @details Runs the kernel over the tile grown by ring cells into its halo.
+void flux_calc_tile(global_variables& globals, int tile, int ring) {
+
+  int x_min, x_max, y_min, y_max;
+  redundant_bounds(globals, tile, ring, x_min, x_max, y_min, y_max);
+
+  flux_calc_kernel(
+    globals.tiles[tile].space,
+    x_min,
+    x_max,
+    y_min,
+    y_max,
+    globals.dt,
+    globals.tiles[tile].field.xarea,
+    globals.tiles[tile].field.yarea,
+    globals.tiles[tile].field.xvel0,
+    globals.tiles[tile].field.yvel0,
+    globals.tiles[tile].field.xvel1,
+    globals.tiles[tile].field.yvel1,
+    globals.tiles[tile].field.vol_flux_x,
+    globals.tiles[tile].field.vol_flux_y);
+}
+
 // @brief Driver for the flux kernels
 // @author Wayne Gaudin
 // @details Invokes the used specified flux kernel
 void flux_calc(global_variables& globals) {
 
-  double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
+  double kernel_time = profiler_start(globals, "flux");
 
 
-  for (int tile=0; tile < globals.tiles_per_chunk; ++tile) {
+  for (int tile=0; tile < globals.local_tiles; ++tile) {
 
-    flux_calc_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.dt,
-      globals.chunk.tiles[tile].field.xarea,
-      globals.chunk.tiles[tile].field.yarea,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.tiles[tile].field.yvel1,
-      globals.chunk.tiles[tile].field.vol_flux_x,
-      globals.chunk.tiles[tile].field.vol_flux_y);
+    flux_calc_tile(globals, tile, 0);
 
   }
 
-  if (globals.profiler_on) globals.profiler.flux += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.flux, kernel_time);
   
 }
 
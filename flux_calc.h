@@ -24,6 +24,7 @@
 #include "definitions.h"
 
 void flux_calc(global_variables& globals);
+void flux_calc_tile(global_variables& globals, int tile, int ring);
 
 #endif
 
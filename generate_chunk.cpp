@@ -80,18 +80,18 @@ void generate_chunk(const int tile, global_variables& globals) {
 
 
 
-  const int x_min = globals.chunk.tiles[tile].t_xmin;
-  const int x_max = globals.chunk.tiles[tile].t_xmax;
-  const int y_min = globals.chunk.tiles[tile].t_ymin;
-  const int y_max = globals.chunk.tiles[tile].t_ymax;
+  const int x_min = globals.tiles[tile].t_xmin;
+  const int x_max = globals.tiles[tile].t_xmax;
+  const int y_min = globals.tiles[tile].t_ymin;
+  const int y_max = globals.tiles[tile].t_ymax;
 
-  size_t xrange = (x_max+2) - (x_min-2) + 1;
-  size_t yrange = (y_max+2) - (y_min-2) + 1;
+  size_t xrange = (x_max+globals.halo_depth) - (x_min-globals.halo_depth) + 1;
+  size_t yrange = (y_max+globals.halo_depth) - (y_min-globals.halo_depth) + 1;
 
   // Take a reference to the lowest structure, as Kokkos device cannot necessarily chase through the structure.
-  field_type& field = globals.chunk.tiles[tile].field;
+  field_type& field = globals.tiles[tile].field;
 
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> xyrange_policy({0,0}, {xrange, yrange});
+  field_policy xyrange_policy({0,0}, {xrange, yrange});
 
   // State 1 is always the background state
   Kokkos::parallel_for(xyrange_policy, KOKKOS_LAMBDA (const int j, const int k) {
@@ -0,0 +1,330 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+//  @brief Halo exchange benchmark
+//  @details Decomposes a mesh over the MPI tasks as clover_leaf does and
+//  times the chunk halo exchange on it, with no hydrodynamics. For each
+//  direction it reports the message size, the cost of packing and unpacking
+//  it, the latency of an empty message and the time and bandwidth of the full
+//  one, with every task sending in that direction at once. The complete
+//  exchange of the fields is then timed as the hydro step calls it. Every
+//  figure is the worst over the tasks.
+//  The options are the exchange keywords of clover.in. With shared_exchange
+//  only the complete exchange goes through shared memory; the per direction
+//  figures are always for messages.
+//  Usage: mpirun -np <tasks> clover_halo_bench [x_cells] [y_cells] [depth]
+//    [fields] [repetitions] [options]
+//  where fields is a comma separated list of up to ten field names, the most
+//  the buffers hold.
+
+#include <mpi.h>
+
+#include <Kokkos_Core.hpp>
+
+#include "build_field.h"
+#include "comms.h"
+#include "definitions.h"
+#include "pack_kernel.h"
+#include "scratch.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Output file handler
+std::ostream g_out(nullptr);
+
+namespace {
+
+const char *field_names[NUM_FIELDS] = {
+  "density0", "density1", "energy0", "energy1", "pressure", "viscosity", "soundspeed",
+  "xvel0", "xvel1", "yvel0", "yvel1", "vol_flux_x", "vol_flux_y", "mass_flux_x", "mass_flux_y"
+};
+
+const char *message_names[8] = {
+  "left", "right", "bottom", "top", "bottom_left", "bottom_right", "top_left", "top_right"
+};
+
+// Sets the field mask from a comma separated list of names, false if a name
+// is not known or there are more than the buffers hold
+bool parse_fields(const std::string& list, int fields[NUM_FIELDS]) {
+
+  for (int field = 0; field < NUM_FIELDS; ++field) fields[field] = 0;
+
+  std::stringstream names(list);
+  std::string name;
+  int count = 0;
+  while (std::getline(names, name, ',')) {
+    int field = 0;
+    while (field < NUM_FIELDS && name != field_names[field]) ++field;
+    if (field == NUM_FIELDS) return false;
+    if (fields[field] == 0) ++count;
+    fields[field] = 1;
+  }
+  return count > 0 && count <= 10;
+}
+
+// The task whose chunk lies across a message, or -1 at the edge of the mesh.
+// It is found from the extents of all the chunks, so that it is right
+// whatever ranks the halo communicator gives the chunks.
+int neighbour_task(const std::vector<int>& extents, const int tasks, const chunk_type& chunk, const int message) {
+
+  const bool left = (message == message_left || message == message_bottom_left || message == message_top_left);
+  const bool right = (message == message_right || message == message_bottom_right || message == message_top_right);
+  const bool bottom = (message == message_bottom || message == message_bottom_left || message == message_bottom_right);
+  const bool top = (message == message_top || message == message_top_left || message == message_top_right);
+
+  const int x = left ? chunk.left-1 : (right ? chunk.right+1 : chunk.left);
+  const int y = bottom ? chunk.bottom-1 : (top ? chunk.top+1 : chunk.bottom);
+
+  for (int task = 0; task < tasks; ++task) {
+    const int *e = &extents[4*task];
+    if (x >= e[0] && x <= e[1] && y >= e[2] && y <= e[3]) return task;
+  }
+  return -1;
+}
+
+int opposite_message(const int message) {
+
+  if (message <= message_top) return message ^ 1;
+  return message_bottom_left + message_top_right - message;
+}
+
+Kokkos::View<double*>::HostMirror& host_buffer(chunk_type& chunk, const int message, const bool send) {
+
+  switch (message) {
+    case message_left:   return send ? chunk.hm_left_snd_buffer   : chunk.hm_left_rcv_buffer;
+    case message_right:  return send ? chunk.hm_right_snd_buffer  : chunk.hm_right_rcv_buffer;
+    case message_bottom: return send ? chunk.hm_bottom_snd_buffer : chunk.hm_bottom_rcv_buffer;
+    case message_top:    return send ? chunk.hm_top_snd_buffer    : chunk.hm_top_rcv_buffer;
+  }
+  return send ? chunk.hm_corner_snd_buffer[message-message_bottom_left] : chunk.hm_corner_rcv_buffer[message-message_bottom_left];
+}
+
+// Seconds per round of sending length doubles across a message while
+// receiving the same message from the opposite neighbour
+double time_messages(chunk_type& chunk, const int to, const int from, const int message, const int length, const int reps) {
+
+  double *snd = host_buffer(chunk, message, true).data();
+  double *rcv = host_buffer(chunk, opposite_message(message), false).data();
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  double start = 0.0;
+  for (int r = -1; r < reps; ++r) {
+    if (r == 0) start = timer(); // The first round is a warm up
+    MPI_Request requests[2];
+    int count = 0;
+    if (from >= 0) MPI_Irecv(rcv, length, MPI_DOUBLE, from, message, MPI_COMM_WORLD, &requests[count++]);
+    if (to >= 0) MPI_Isend(snd, length, MPI_DOUBLE, to, message, MPI_COMM_WORLD, &requests[count++]);
+    MPI_Waitall(count, requests, MPI_STATUSES_IGNORE);
+  }
+  return (timer()-start)/reps;
+}
+
+double worst(double value) {
+
+  double maximum;
+  MPI_Reduce(&value, &maximum, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  return maximum;
+}
+}
+
+int main(int argc, char *argv[]) {
+
+  MPI_Init(&argc, &argv);
+  Kokkos::initialize(argc, argv);
+  {
+    parallel_ parallel;
+    if (parallel.boss) g_out.rdbuf(std::cout.rdbuf());
+
+    int x_cells = (argc > 1) ? std::atoi(argv[1]) : 1024;
+    int y_cells = (argc > 2) ? std::atoi(argv[2]) : 1024;
+    int depth = (argc > 3) ? std::atoi(argv[3]) : 2;
+    std::string field_list = (argc > 4) ? argv[4] : "density0,energy0,pressure,viscosity,xvel0,yvel0";
+    int reps = (argc > 5) ? std::atoi(argv[5]) : 100;
+
+    global_variables globals;
+    globals.tiles_per_chunk = 1;
+    globals.field_padding = 0;
+    globals.fused_timestep = false;
+    globals.fused_advec_cell = false;
+    globals.fused_advec_mom = false;
+    globals.overlap_halo = false;
+    globals.exchange_corners = false;
+    globals.cartesian_topology = false;
+    globals.neighbour_exchange = false;
+    globals.shared_exchange = false;
+    globals.halo_depth = std::max(depth, 2);
+    globals.grid.x_cells = x_cells;
+    globals.grid.y_cells = y_cells;
+
+    bool usage = (x_cells < 1 || y_cells < 1 || depth < 1 || reps < 1);
+    int fields[NUM_FIELDS];
+    if (!parse_fields(field_list, fields)) usage = true;
+    for (int a = 6; a < argc; ++a) {
+      if (std::strcmp(argv[a], "exchange_corners") == 0) globals.exchange_corners = true;
+      else if (std::strcmp(argv[a], "cartesian_topology") == 0) globals.cartesian_topology = true;
+      else if (std::strcmp(argv[a], "neighbour_exchange") == 0) globals.cartesian_topology = globals.neighbour_exchange = true;
+      else if (std::strcmp(argv[a], "shared_exchange") == 0) globals.shared_exchange = true;
+      else usage = true;
+    }
+    if (globals.shared_exchange && globals.neighbour_exchange) usage = true;
+
+    if (usage) {
+      if (parallel.boss) {
+        std::cerr << "Usage: clover_halo_bench [x_cells] [y_cells] [depth] [fields] [repetitions] [options]" << std::endl
+          << "  fields: comma separated list of up to ten of";
+        for (int field = 0; field < NUM_FIELDS; ++field) std::cerr << " " << field_names[field];
+        std::cerr << std::endl
+          << "  options: exchange_corners cartesian_topology neighbour_exchange shared_exchange" << std::endl;
+      }
+      Kokkos::finalize();
+      MPI_Finalize();
+      return EXIT_FAILURE;
+    }
+
+    // Set up one chunk per task as start does
+    globals.number_of_chunks = parallel.max_task;
+    clover_decompose(globals, parallel, x_cells, y_cells);
+
+    globals.local_tiles = globals.tiles_per_chunk;
+    globals.tiles = new tile_type[globals.local_tiles];
+
+    chunk_type& chunk = globals.chunks[0];
+    clover_tile_decompose(globals, 0);
+    scratch_plan(globals);
+    build_field(globals);
+    clover_allocate_buffers(globals, parallel);
+
+    int extent[4] = {chunk.left, chunk.right, chunk.bottom, chunk.top};
+    std::vector<int> extents(4*parallel.max_task);
+    MPI_Allgather(extent, 4, MPI_INT, extents.data(), 4, MPI_INT, MPI_COMM_WORLD);
+
+    // Each field fills the same length of every message, as in the exchange
+    const int h = globals.halo_depth;
+    int field_count = 0;
+    for (int field = 0; field < NUM_FIELDS; ++field) field_count += fields[field];
+
+    if (parallel.boss) {
+      std::cout << "Halo exchange benchmark, " << parallel.max_task << " tasks, "
+        << x_cells << " x " << y_cells << " cells, depth " << depth << ", "
+        << field_count << " fields, " << reps << " repetitions" << std::endl
+        << "Times in microseconds, the worst over the tasks" << std::endl << std::endl
+        << std::setw(14) << "Direction" << std::setw(12) << "Bytes"
+        << std::setw(12) << "Pack" << std::setw(12) << "Unpack"
+        << std::setw(12) << "Latency" << std::setw(12) << "Message" << std::setw(12) << "GB/s" << std::endl;
+    }
+
+    const int directions = globals.exchange_corners ? 8 : 4;
+    for (int message = 0; message < directions; ++message) {
+      const int per_field = (message == message_left || message == message_right) ? depth*(chunk.y_max+2*h+1) :
+        (message <= message_top) ? depth*(chunk.x_max+2*h+1) : depth*depth;
+      int offset[NUM_FIELDS];
+      int length = 0;
+      for (int field = 0; field < NUM_FIELDS; ++field) {
+        if (fields[field] == 0) continue;
+        offset[field] = length;
+        length += per_field;
+      }
+
+      const int to = neighbour_task(extents, parallel.max_task, chunk, message);
+      const int from = neighbour_task(extents, parallel.max_task, chunk, opposite_message(message));
+
+      double pack = 0.0, unpack = 0.0;
+      if (to >= 0) {
+        clover_pack_tile(globals, 0, message, fields, depth, offset);
+        Kokkos::fence();
+        double start = timer();
+        for (int r = 0; r < reps; ++r) clover_pack_tile(globals, 0, message, fields, depth, offset);
+        Kokkos::fence();
+        pack = (timer()-start)/reps;
+      }
+      if (from >= 0) {
+        const int received = opposite_message(message);
+        clover_unpack_tile(globals, 0, received, fields, depth, offset);
+        Kokkos::fence();
+        double start = timer();
+        for (int r = 0; r < reps; ++r) clover_unpack_tile(globals, 0, received, fields, depth, offset);
+        Kokkos::fence();
+        unpack = (timer()-start)/reps;
+      }
+
+      const double latency = time_messages(chunk, to, from, message, 0, reps);
+      const double transfer = time_messages(chunk, to, from, message, length, reps);
+      const double bytes = (to >= 0) ? length*sizeof(double) : 0.0;
+
+      pack = worst(pack);
+      unpack = worst(unpack);
+      const double worst_latency = worst(latency);
+      const double worst_transfer = worst(transfer);
+      const double worst_bytes = worst(bytes);
+
+      if (parallel.boss && worst_bytes > 0.0) {
+        std::cout << std::setw(14) << message_names[message] << std::setw(12) << (long)worst_bytes
+          << std::fixed << std::setprecision(2)
+          << std::setw(12) << 1.0e6*pack << std::setw(12) << 1.0e6*unpack
+          << std::setw(12) << 1.0e6*worst_latency << std::setw(12) << 1.0e6*worst_transfer
+          << std::setw(12) << 1.0e-9*worst_bytes/worst_transfer << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+      }
+    }
+
+    // The complete exchange, as update_halo makes it
+    double bytes = 0.0;
+    for (int face = 0; face < 4; ++face) {
+      if (chunk.chunk_neighbours[face] == external_face) continue;
+      bytes += field_count*depth*((face <= chunk_right ? chunk.y_max : chunk.x_max)+2*h+1)*sizeof(double);
+    }
+    if (globals.exchange_corners) {
+      for (int corner = 0; corner < 4; ++corner) {
+        if (chunk.corner_neighbours[corner] != external_face) bytes += field_count*depth*depth*sizeof(double);
+      }
+    }
+
+    clover_exchange(globals, fields, depth);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = timer();
+    for (int r = 0; r < reps; ++r) clover_exchange(globals, fields, depth);
+    double exchange = worst((timer()-start)/reps);
+    bytes = worst(bytes);
+
+    if (parallel.boss) {
+      std::cout << std::endl << "Complete exchange " << std::fixed << std::setprecision(2)
+        << 1.0e6*exchange << " us, " << (long)bytes << " bytes sent by the busiest task, "
+        << 1.0e-9*bytes/exchange << " GB/s" << std::endl;
+    }
+
+    clover_free_halo_plans();
+    delete[] globals.tiles;
+    delete[] globals.chunks;
+    delete[] globals.chunk_task;
+  }
+  Kokkos::finalize();
+  MPI_Finalize();
+
+  return EXIT_SUCCESS;
+}
+
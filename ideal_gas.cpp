@@ -19,21 +19,23 @@
 
 
 #include "ideal_gas.h"
+#include "update_halo.h"
 
 //  @brief Fortran ideal gas kernel.
 //  @author Wayne Gaudin
 //  @details Calculates the pressure and sound speed for the mesh chunk using
 //  the ideal gas equation of state, with a fixed gamma of 1.4.
 void ideal_gas_kernel(
-  int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& density,
-  Kokkos::View<double**>& energy,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& soundspeed) {
+  const exec_space& space,
+  int x_min, int x_max, int y_min, int y_max, int depth,
+  field_view& density,
+  field_view& energy,
+  field_view& pressure,
+  work_view& soundspeed) {
 
-  // DO k=y_min,y_max
-  //   DO j=x_min,x_max
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min+1, y_min+1}, {x_max+2, y_max+2});
+  // DO k=y_min-depth,y_max+depth
+  //   DO j=x_min-depth,x_max+depth
+  field_policy policy(space, {x_min-depth+1, y_min-depth+1}, {x_max+depth+2, y_max+depth+2});
 
   Kokkos::parallel_for("ideal_gas", policy, KOKKOS_LAMBDA (const int j, const int k) {
     double v = 1.0/density(j,k);
@@ -49,31 +51,59 @@ void ideal_gas_kernel(
 //  @brief Ideal gas kernel driver
 //  @author Wayne Gaudin
 //  @details Invokes the user specified kernel for the ideal gas equation of
-//  state using the specified time level data.
+//  state using the specified time level data, over the tile and ring cells of
+//  its halo on the faces shared with other tiles or chunks.
 
-void ideal_gas(global_variables& globals, const int tile, bool predict) {
+void ideal_gas(global_variables& globals, const int tile, bool predict, const int ring) {
+
+  int x_min, x_max, y_min, y_max;
+  redundant_bounds(globals, tile, ring, x_min, x_max, y_min, y_max);
 
   if (!predict) {
     ideal_gas_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.tiles[tile].field.soundspeed);
+      globals.tiles[tile].space,
+      x_min,
+      x_max,
+      y_min,
+      y_max,
+      0,
+      globals.tiles[tile].field.density0,
+      globals.tiles[tile].field.energy0,
+      globals.tiles[tile].field.pressure,
+      globals.tiles[tile].field.soundspeed);
   }
   else {
     ideal_gas_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.tiles[tile].field.pressure,
-      globals.chunk.tiles[tile].field.soundspeed);
+      globals.tiles[tile].space,
+      x_min,
+      x_max,
+      y_min,
+      y_max,
+      0,
+      globals.tiles[tile].field.density1,
+      globals.tiles[tile].field.energy1,
+      globals.tiles[tile].field.pressure,
+      globals.tiles[tile].field.soundspeed);
   }
 }
 
+//  @brief Ideal gas kernel driver including the halo
+//  @details Evaluates the equation of state on time level 0 over the tile and
+//  depth cells of its halo. Once density and energy have been exchanged this
+//  gives the same halo pressure as exchanging the pressure itself.
+
+void ideal_gas_halo(global_variables& globals, const int tile, const int depth) {
+
+  ideal_gas_kernel(
+    globals.tiles[tile].space,
+    globals.tiles[tile].t_xmin,
+    globals.tiles[tile].t_xmax,
+    globals.tiles[tile].t_ymin,
+    globals.tiles[tile].t_ymax,
+    depth,
+    globals.tiles[tile].field.density0,
+    globals.tiles[tile].field.energy0,
+    globals.tiles[tile].field.pressure,
+    globals.tiles[tile].field.soundspeed);
+}
+
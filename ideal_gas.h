@@ -23,7 +23,8 @@
 
 #include "definitions.h"
 
-void ideal_gas(global_variables& globals, const int tile, bool predict);
+void ideal_gas(global_variables& globals, const int tile, bool predict, const int ring);
+void ideal_gas_halo(global_variables& globals, const int tile, const int depth);
 
 #endif
 
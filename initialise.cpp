@@ -94,6 +94,12 @@ void initialise(parallel_ &parallel, global_variables& globals) {
 
   clover_barrier();
 
+  // Every task reads the input, so the other tasks open it once the boss has
+  // made sure it exists
+  if (!parallel.boss) {
+    g_in.open("clover.in");
+  }
+
   if (parallel.boss) {
     g_out << std::endl
       << "Initialising and generating" << std::endl
@@ -32,9 +32,9 @@ void initialise_chunk(const int tile, global_variables& globals) {
   double dx = (globals.grid.xmax-globals.grid.xmin)/(double)(globals.grid.x_cells);
   double dy = (globals.grid.ymax-globals.grid.ymin)/(double)(globals.grid.y_cells);
 
-  double xmin = globals.grid.xmin+dx*(double)(globals.chunk.tiles[tile].t_left-1);
+  double xmin = globals.grid.xmin+dx*(double)(globals.tiles[tile].t_left-1);
 
-  double ymin = globals.grid.ymin+dy*(double)(globals.chunk.tiles[tile].t_bottom-1);
+  double ymin = globals.grid.ymin+dy*(double)(globals.tiles[tile].t_bottom-1);
 
 ////    CALL initialise_chunk_kernel(chunk%tiles(tile)%t_xmin,    &
  //     chunk%tiles(tile)%t_xmax,    &
@@ -53,16 +53,18 @@ void initialise_chunk(const int tile, global_variables& globals) {
  //     chunk%tiles(tile)%field%xarea,    &
  //     chunk%tiles(tile)%field%yarea     )
 
-  const int x_min = globals.chunk.tiles[tile].t_xmin;
-  const int x_max = globals.chunk.tiles[tile].t_xmax;
-  const int y_min = globals.chunk.tiles[tile].t_ymin;
-  const int y_max = globals.chunk.tiles[tile].t_ymax;
+  const int x_min = globals.tiles[tile].t_xmin;
+  const int x_max = globals.tiles[tile].t_xmax;
+  const int y_min = globals.tiles[tile].t_ymin;
+  const int y_max = globals.tiles[tile].t_ymax;
 
-  size_t xrange = (x_max+3) - (x_min-2) + 1;
-  size_t yrange = (y_max+3) - (y_min-2) + 1;
+  const int h = globals.halo_depth;
+
+  size_t xrange = (x_max+h+1) - (x_min-h) + 1;
+  size_t yrange = (y_max+h+1) - (y_min-h) + 1;
 
   // Take a reference to the lowest structure, as Kokkos device cannot necessarily chase through the structure.
-  field_type& field = globals.chunk.tiles[tile].field;
+  field_type& field = globals.tiles[tile].field;
 
   Kokkos::parallel_for(xrange, KOKKOS_LAMBDA (const int j) {
     field.vertexx(j) = xmin + dx*(double)(j-1-x_min);
@@ -74,8 +76,8 @@ void initialise_chunk(const int tile, global_variables& globals) {
     field.vertexdy(k) = dy;
   });
 
-  xrange = (x_max+2) - (x_min-2) + 1;
-  yrange = (y_max+2) - (y_min-2) + 1;
+  xrange = (x_max+h) - (x_min-h) + 1;
+  yrange = (y_max+h) - (y_min-h) + 1;
 
   Kokkos::parallel_for(xrange, KOKKOS_LAMBDA (const int j) {
     field.cellx(j) = 0.5*(field.vertexx(j) + field.vertexx(j+1));
@@ -87,7 +89,7 @@ void initialise_chunk(const int tile, global_variables& globals) {
     field.celldy(k) = dy;
   });
 
-  Kokkos::parallel_for(Kokkos::MDRangePolicy<Kokkos::Rank<2>>({0,0}, {xrange, yrange}), KOKKOS_LAMBDA (const int j, const int k) {
+  Kokkos::parallel_for(field_policy({0,0}, {xrange, yrange}), KOKKOS_LAMBDA (const int j, const int k) {
     field.volume(j,k) = dx*dy;
     field.xarea(j,k) = field.celldy(k);
     field.yarea(j,k) = field.celldx(j);
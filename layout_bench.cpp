@@ -0,0 +1,193 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+//  @brief Field layout benchmark
+//  @details Runs kernels with the access patterns of the ideal gas, viscosity
+//  and the x and y advection sweeps on fields of each memory layout, iterated
+//  in each order, and reports the effective bandwidth of each. The fastest
+//  matched pair is the one to build clover_leaf with (see CLOVER_LAYOUT).
+//  Usage: clover_layout_bench [cells] [repetitions]
+
+#include <Kokkos_Core.hpp>
+
+#include "viscosity.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const char *layout_name(Kokkos::LayoutLeft) { return "Left"; }
+const char *layout_name(Kokkos::LayoutRight) { return "Right"; }
+
+const char *iterate_name(Kokkos::Iterate it) {
+  return it == Kokkos::Iterate::Left ? "Left" : "Right";
+}
+
+template<class layout, Kokkos::Iterate order>
+struct bench_case {
+
+  typedef Kokkos::View<double**, layout> view_2d;
+  typedef Kokkos::View<double*> view_1d;
+  typedef Kokkos::MDRangePolicy<Kokkos::Rank<2, order, order>> policy;
+
+  int cells;
+  int reps;
+
+  view_1d celldx, celldy;
+  view_2d density, energy, pressure, soundspeed, xvel, yvel, viscosity, vol_flux, mass_flux;
+
+  bench_case(int cells_, int reps_) : cells(cells_), reps(reps_),
+    celldx("celldx", cells+4), celldy("celldy", cells+4),
+    density("density", cells+4, cells+4), energy("energy", cells+4, cells+4),
+    pressure("pressure", cells+4, cells+4), soundspeed("soundspeed", cells+4, cells+4),
+    xvel("xvel", cells+5, cells+5), yvel("yvel", cells+5, cells+5),
+    viscosity("viscosity", cells+4, cells+4), vol_flux("vol_flux", cells+5, cells+4),
+    mass_flux("mass_flux", cells+5, cells+4) {
+
+    Kokkos::deep_copy(celldx, 1.0/cells);
+    Kokkos::deep_copy(celldy, 1.0/cells);
+
+    const int n = cells;
+    view_2d d = density, e = energy, p = pressure, u = xvel, v = yvel, f = vol_flux;
+    Kokkos::parallel_for("layout_bench_init", policy({0, 0}, {n+4, n+4}), KOKKOS_LAMBDA (const int j, const int k) {
+      d(j,k) = 1.0 + 0.1*((j+k)%7);
+      e(j,k) = 2.5 - 0.1*((j*k)%5);
+      p(j,k) = 0.4*d(j,k)*e(j,k);
+      u(j,k) = 0.01*((j%3) - 1);
+      v(j,k) = 0.01*((k%3) - 1);
+      f(j,k) = 0.001*((j+2*k)%5 - 2);
+    });
+    Kokkos::fence();
+  }
+
+  // Runs the kernel reps times after a warm up and returns GB/s, counting
+  // each field touched once per cell
+  template<class kernel_type>
+  double time(const kernel_type& kernel, int fields) {
+    kernel();
+    Kokkos::fence();
+    Kokkos::Timer timer;
+    for (int r = 0; r < reps; r++) kernel();
+    Kokkos::fence();
+    double seconds = timer.seconds();
+    return 1.0e-9*fields*sizeof(double)*double(cells)*cells*reps/seconds;
+  }
+
+  double ideal_gas() {
+    view_2d d = density, e = energy, p = pressure, ss = soundspeed;
+    const int n = cells;
+    return time([=] () {
+      Kokkos::parallel_for("layout_bench_ideal_gas", policy({2, 2}, {n+2, n+2}), KOKKOS_LAMBDA (const int j, const int k) {
+        double v = 1.0/d(j,k);
+        p(j,k) = (1.4 - 1.0)*d(j,k)*e(j,k);
+        double pressurebyenergy = (1.4 - 1.0)*d(j,k);
+        double pressurebyvolume = -d(j,k)*p(j,k);
+        double sound_speed_squared = v*v*(p(j,k)*pressurebyenergy - pressurebyvolume);
+        ss(j,k) = sqrt(sound_speed_squared);
+      });
+    }, 4);
+  }
+
+  double viscosity_kernel() {
+    view_1d dx = celldx, dy = celldy;
+    view_2d d = density, p = pressure, u = xvel, v = yvel, q = viscosity;
+    const int n = cells;
+    return time([=] () {
+      Kokkos::parallel_for("layout_bench_viscosity", policy({2, 2}, {n+2, n+2}), KOKKOS_LAMBDA (const int j, const int k) {
+        q(j,k) = viscosity_cell(j, k, dx, dy, d, p, u, v);
+      });
+    }, 5);
+  }
+
+  // Donor cell flux with a van Leer limited correction, as in the density
+  // sweep of advec_cell, reading along the sweep direction
+  template<int dir>
+  double sweep() {
+    view_2d d = density, f = vol_flux, m = mass_flux;
+    const int n = cells;
+    return time([=] () {
+      Kokkos::parallel_for("layout_bench_sweep", policy({2, 2}, {n+3, n+2}), KOKKOS_LAMBDA (const int j, const int k) {
+        const int jd = (dir == 1) ? 1 : 0;
+        const int kd = (dir == 1) ? 0 : 1;
+        int upwind, donor, downwind;
+        if (f(j,k) > 0.0) {
+          upwind = -2; donor = -1; downwind = 0;
+        } else {
+          upwind = 1; donor = 0; downwind = -1;
+        }
+        double diffuw = d(j+jd*donor,k+kd*donor) - d(j+jd*upwind,k+kd*upwind);
+        double diffdw = d(j+jd*downwind,k+kd*downwind) - d(j+jd*donor,k+kd*donor);
+        double limiter = 0.0;
+        if (diffuw*diffdw > 0.0) {
+          limiter = (1.0 - fabs(f(j,k)))*copysign(1.0, diffdw)
+            *fmin(fabs(diffuw), fabs(diffdw))*0.5;
+        }
+        m(j,k) = f(j,k)*(d(j+jd*donor,k+kd*donor) + limiter);
+      });
+    }, 3);
+  }
+};
+
+template<class layout, Kokkos::Iterate order>
+void run_case(int cells, int reps, bool matched) {
+  bench_case<layout, order> bench(cells, reps);
+  double gas = bench.ideal_gas();
+  double visc = bench.viscosity_kernel();
+  double xsweep = bench.template sweep<1>();
+  double ysweep = bench.template sweep<2>();
+  std::cout << std::setw(8) << layout_name(layout()) << std::setw(9) << iterate_name(order)
+    << std::setw(9) << (matched ? "yes" : "no")
+    << std::fixed << std::setprecision(2)
+    << std::setw(12) << gas << std::setw(12) << visc
+    << std::setw(12) << xsweep << std::setw(12) << ysweep << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+
+  Kokkos::initialize(argc, argv);
+  {
+    int cells = (argc > 1) ? std::atoi(argv[1]) : 2048;
+    int reps = (argc > 2) ? std::atoi(argv[2]) : 20;
+    if (cells < 1 || reps < 1) {
+      std::cerr << "Usage: clover_layout_bench [cells] [repetitions]" << std::endl;
+      Kokkos::finalize();
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Layout benchmark, " << cells << " x " << cells << " cells, "
+      << reps << " repetitions, effective GB/s" << std::endl << std::endl;
+    std::cout << std::setw(8) << "Layout" << std::setw(9) << "Iterate" << std::setw(9) << "Matched"
+      << std::setw(12) << "ideal_gas" << std::setw(12) << "viscosity"
+      << std::setw(12) << "x_sweep" << std::setw(12) << "y_sweep" << std::endl;
+
+    run_case<Kokkos::LayoutLeft, Kokkos::Iterate::Left>(cells, reps, true);
+    run_case<Kokkos::LayoutLeft, Kokkos::Iterate::Right>(cells, reps, false);
+    run_case<Kokkos::LayoutRight, Kokkos::Iterate::Right>(cells, reps, true);
+    run_case<Kokkos::LayoutRight, Kokkos::Iterate::Left>(cells, reps, false);
+  }
+  Kokkos::finalize();
+
+  return EXIT_SUCCESS;
+}
+
@@ -20,310 +20,121 @@
 
 //  @brief Fortran mpi buffer packing kernel
 //  @author Wayne Gaudin
-//  @details Packs/unpacks mpi send and receive buffers
+//  @details Packs/unpacks mpi send and receive buffers. Every field of a
+//  message is handled in one launch, so the launch count per exchange does
+//  not grow with the number of fields.
 
 #include "pack_kernel.h"
 
-void clover_pack_message_left(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& left_snd_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
-
-  // Pack
-
-  int x_inc, y_inc;
-
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
-  }
-
-  // DO k=y_min-depth,y_max+y_inc+depth
-  Kokkos::RangePolicy<> range(y_min-depth+1, y_max+y_inc+depth+2);
-  Kokkos::parallel_for("clover_pack_message_left", range, KOKKOS_LAMBDA (const int k) {
-    for (int j = 0; j < depth; ++j) {
-      int index = buffer_offset + j + (k+depth-1) * depth;
-      left_snd_buffer(index) = field(x_min+x_inc-1+j,k);
-    }
-  });
-
-}
-
-
-void clover_unpack_message_left(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& left_rcv_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
-
-  // Upnack
-
-  int x_inc, y_inc;
-
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
-  }
-
-  // DO k=y_min-depth,y_max+y_inc+depth
-  Kokkos::RangePolicy<> range(y_min-depth+1, y_max+y_inc+depth+2);
-  Kokkos::parallel_for("clover_unpack_message_left", range, KOKKOS_LAMBDA (const int k) {
-    for (int j = 0; j < depth; ++j) {
-      int index = buffer_offset + j + (k+depth-1) * depth;
-      field(x_min-j,k) = left_rcv_buffer(index);
-    }
-  });
-
+// Column of a left or right message at distance d from the edge. Packing
+// reads the donor cells inside the tile, unpacking writes the halo beyond it.
+KOKKOS_INLINE_FUNCTION
+int clover_message_column(bool left, bool pack, int x_min, int x_max, int x_inc, int d) {
+  if (pack) return left ? x_min+x_inc+1+d : x_max+1-d;
+  return left ? x_min-d : x_max+x_inc+2+d;
 }
 
-
-void clover_pack_message_right(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& right_snd_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
-
-  // Pack
-
-  int x_inc, y_inc;
-
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
-  }
-
-  // DO k=y_min-depth,y_max+y_inc+depth
-  Kokkos::RangePolicy<> range(y_min-depth+1, y_max+y_inc+depth+2);
-  Kokkos::parallel_for("clover_pack_message_right", range, KOKKOS_LAMBDA (const int k) {
-    for (int j = 0; j < depth; ++j) {
-      int index = buffer_offset + j + (k+depth-1) * depth;
-      right_snd_buffer(index) = field(x_min+1+j,k);
-    }
-  });
-
+// Row of a bottom or top message at distance d from the edge
+KOKKOS_INLINE_FUNCTION
+int clover_message_row(bool bottom, bool pack, int y_min, int y_max, int y_inc, int d) {
+  if (pack) return bottom ? y_min+y_inc+1+d : y_max+1-d;
+  return bottom ? y_min-d : y_max+y_inc+2+d;
 }
 
-
-void clover_unpack_message_right(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& right_rcv_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
-
-  // Upnack
-
-  int x_inc, y_inc;
-
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
-  }
-
-  // DO k=y_min-depth,y_max+y_inc+depth
-  Kokkos::RangePolicy<> range(y_min-depth+1, y_max+y_inc+depth+2);
-  Kokkos::parallel_for("clover_pack_message_left", range, KOKKOS_LAMBDA (const int k) {
-    for (int j = 0; j < depth; ++j) {
-      int index = buffer_offset + j + (k+depth-1) * depth;
-      right_rcv_buffer(index) = field(x_max+x_inc+j,k);
-    }
-  });
-
-}
-
-void clover_pack_message_top(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& top_snd_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
-
-  // Pack
-
-  int x_inc, y_inc;
-
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
+// Copies between the fields of a list and a buffer, in the direction given by
+// pack
+template<bool pack, class view_type>
+void clover_copy_message(int message, int x_min, int x_max, int y_min, int y_max,
+  const pack_list<view_type>& list, Kokkos::View<double*>& buffer, int depth) {
+
+  if (list.count == 0) return;
+
+  const pack_list<view_type> fields = list;
+  const std::string name = pack ? "clover_pack_message" : "clover_unpack_message";
+
+  const bool left = (message == message_left) || (message == message_bottom_left) || (message == message_top_left);
+  const bool bottom = (message == message_bottom) || (message == message_bottom_left) || (message == message_bottom_right);
+
+  if (message == message_left || message == message_right) {
+    // The strip covers the halo at both ends, one further for fields with an
+    // extra vertex or face along it
+    // DO k=y_min-depth,y_max+y_inc+depth
+    //   DO f=1,count
+    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({y_min-depth+1, 0}, {y_max+1+depth+2, fields.count});
+    Kokkos::parallel_for(name, policy, KOKKOS_LAMBDA (const int k, const int f) {
+      const int type = fields.data_type[f];
+      const int x_inc = (type == vertex_data || type == x_face_data) ? 1 : 0;
+      const int y_inc = (type == vertex_data || type == y_face_data) ? 1 : 0;
+      if (k > y_max+y_inc+depth+1) return;
+
+      for (int j = 0; j < depth; ++j) {
+        int index = fields.offset[f] + j + (k-y_min+depth-1) * depth;
+        int jf = clover_message_column(left, pack, x_min, x_max, x_inc, j);
+        if (pack) buffer(index) = fields.field[f](jf,k);
+        else      fields.field[f](jf,k) = buffer(index);
+      }
+    });
   }
-
-  for (int k = 0; k < depth; ++k) {
+  else if (message == message_bottom || message == message_top) {
     // DO j=x_min-depth,x_max+x_inc+depth
-    Kokkos::RangePolicy<> range(x_min-depth+1, x_max+x_inc+depth+2);
-    Kokkos::parallel_for("clover_pack_message_top", range, KOKKOS_LAMBDA (const int j) {
-      int index = buffer_offset + k + (j+depth-1) * depth;
-      top_snd_buffer(index) = field(j,y_max+1-k);
+    //   DO f=1,count
+    Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min-depth+1, 0}, {x_max+1+depth+2, fields.count});
+    Kokkos::parallel_for(name, policy, KOKKOS_LAMBDA (const int j, const int f) {
+      const int type = fields.data_type[f];
+      const int x_inc = (type == vertex_data || type == x_face_data) ? 1 : 0;
+      const int y_inc = (type == vertex_data || type == y_face_data) ? 1 : 0;
+      if (j > x_max+x_inc+depth+1) return;
+
+      for (int k = 0; k < depth; ++k) {
+        int index = fields.offset[f] + k + (j-x_min+depth-1) * depth;
+        int kf = clover_message_row(bottom, pack, y_min, y_max, y_inc, k);
+        if (pack) buffer(index) = fields.field[f](j,kf);
+        else      fields.field[f](j,kf) = buffer(index);
+      }
     });
   }
-}
-
-void clover_unpack_message_top(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& top_rcv_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
-
-  // Unpack
-
-  int x_inc, y_inc;
-
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
-  }
-
-  for (int k = 0; k < depth; ++k) {
-    // DO j=x_min-depth,x_max+x_inc+depth
-    Kokkos::RangePolicy<> range(x_min-depth+1, x_max+x_inc+depth+2);
-    Kokkos::parallel_for("clover_unpack_message_top", range, KOKKOS_LAMBDA (const int j) {
-      int index = buffer_offset + k + (j+depth-1) * depth;
-      field(j,y_max+y_inc+k) = top_rcv_buffer(index);
+  else {
+    // The depth by depth block nearest the corner, in the order the diagonal
+    // neighbour's opposite corner expects
+    // DO f=1,count
+    Kokkos::RangePolicy<> range(0, fields.count);
+    Kokkos::parallel_for(name, range, KOKKOS_LAMBDA (const int f) {
+      const int type = fields.data_type[f];
+      const int x_inc = (type == vertex_data || type == x_face_data) ? 1 : 0;
+      const int y_inc = (type == vertex_data || type == y_face_data) ? 1 : 0;
+      for (int k = 0; k < depth; ++k) {
+        for (int j = 0; j < depth; ++j) {
+          int index = fields.offset[f] + j + k * depth;
+          int jf = clover_message_column(left, pack, x_min, x_max, x_inc, j);
+          int kf = clover_message_row(bottom, pack, y_min, y_max, y_inc, k);
+          if (pack) buffer(index) = fields.field[f](jf,kf);
+          else      fields.field[f](jf,kf) = buffer(index);
+        }
+      }
     });
   }
 }
 
+template<class view_type>
+void clover_pack_message(int message, int x_min, int x_max, int y_min, int y_max,
+  const pack_list<view_type>& list, Kokkos::View<double*>& snd_buffer, int depth) {
 
-void clover_pack_message_bottom(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& bottom_snd_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
-
-  // Pack
-
-  int x_inc, y_inc;
-
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
-  }
-
-  for (int k = 0; k < depth; ++k) {
-    // DO j=x_min-depth,x_max+x_inc+depth
-    Kokkos::RangePolicy<> range(x_min-depth+1, x_max+x_inc+depth+2);
-    Kokkos::parallel_for("clover_pack_message_bottom", range, KOKKOS_LAMBDA (const int j) {
-      int index = buffer_offset + k + (j+depth-1) * depth;
-      bottom_snd_buffer(index) = field(j,y_min+y_inc-1+k);
-    });
-  }
+  clover_copy_message<true>(message, x_min, x_max, y_min, y_max, list, snd_buffer, depth);
 }
 
-void clover_unpack_message_bottom(int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& field, Kokkos::View<double*>& bottom_rcv_buffer,
-  int cell_data, int vertex_data, int x_face_data, int y_face_data,
-  int depth, int field_type, int buffer_offset) {
+template<class view_type>
+void clover_unpack_message(int message, int x_min, int x_max, int y_min, int y_max,
+  const pack_list<view_type>& list, Kokkos::View<double*>& rcv_buffer, int depth) {
 
-  // Unpack
-
-  int x_inc, y_inc;
+  clover_copy_message<false>(message, x_min, x_max, y_min, y_max, list, rcv_buffer, depth);
+}
 
-  // These array modifications still need to be added on, plus the donor data location changes as in update_halo
-  if (field_type == cell_data) {
-    x_inc = 0;
-    y_inc = 0;
-  }
-  if (field_type == vertex_data) {
-    x_inc = 1;
-    y_inc = 1;
-  }
-  if (field_type == x_face_data) {
-    x_inc = 1;
-    y_inc = 0;
-  }
-  if (field_type == y_face_data) {
-    x_inc = 0;
-    y_inc = 1;
-  }
+// The work fields may be stored in a different precision to the others, so
+// the kernels are instantiated for both view types
+template void clover_pack_message<field_view>(int, int, int, int, int, const pack_list<field_view>&, Kokkos::View<double*>&, int);
+template void clover_unpack_message<field_view>(int, int, int, int, int, const pack_list<field_view>&, Kokkos::View<double*>&, int);
+#if defined(CLOVER_MIXED_PRECISION)
+template void clover_pack_message<work_view>(int, int, int, int, int, const pack_list<work_view>&, Kokkos::View<double*>&, int);
+template void clover_unpack_message<work_view>(int, int, int, int, int, const pack_list<work_view>&, Kokkos::View<double*>&, int);
+#endif
 
-  for (int k = 0; k < depth; ++k) {
-    // DO j=x_min-depth,x_max+x_inc+depth
-    Kokkos::RangePolicy<> range(x_min-depth+1, x_max+x_inc+depth+2);
-    Kokkos::parallel_for("clover_unpack_message_top", range, KOKKOS_LAMBDA (const int j) {
-      int index = buffer_offset + k + (j+depth-1) * depth;
-      field(j,y_min-k) = bottom_rcv_buffer(index);
-    });
-  }
-}
@@ -21,16 +21,38 @@
 #ifndef PACK_KERNEL_H
 #define PACK_KERNEL_H
 
-#include <Kokkos_Core.hpp>
-
-void clover_pack_message_left(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& left_snd_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
-void clover_unpack_message_left(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& left_rcv_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
-void clover_pack_message_right(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& right_snd_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
-void clover_unpack_message_right(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& right_rcv_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
-void clover_pack_message_top(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& top_snd_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
-void clover_unpack_message_top(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& top_rcv_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
-void clover_pack_message_bottom(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& bottom_snd_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
-void clover_unpack_message_bottom(int x_min, int x_max, int y_min, int y_max, Kokkos::View<double**>& field, Kokkos::View<double*>& bottom_rcv_buffer, int cell_data, int vertex_data, int x_face_fata, int y_face_data, int depth, int field_type, int buffer_offset);
+#include "definitions.h"
+
+// Halo region a message is packed from or unpacked into. The edges come first
+// in chunk_neighbour_type order and the corners follow in chunk_corner_type
+// order.
+enum halo_message {
+  message_left = 0, message_right = 1, message_bottom = 2, message_top = 3,
+  message_bottom_left = 4, message_bottom_right = 5, message_top_left = 6, message_top_right = 7
+};
+
+// Fields of one tile packed into or unpacked from a buffer in a single launch,
+// each with its data type and offset into the buffer
+template<class view_type>
+struct pack_list {
+
+  int count;
+  view_type field[NUM_FIELDS];
+  int data_type[NUM_FIELDS];
+  int offset[NUM_FIELDS];
+
+  pack_list() : count(0) {}
+
+  void add(const view_type& view, int type, int buffer_offset) {
+    field[count] = view;
+    data_type[count] = type;
+    offset[count] = buffer_offset;
+    count++;
+  }
+};
+
+template<class view_type> void clover_pack_message(int message, int x_min, int x_max, int y_min, int y_max, const pack_list<view_type>& list, Kokkos::View<double*>& snd_buffer, int depth);
+template<class view_type> void clover_unpack_message(int message, int x_min, int x_max, int y_min, int y_max, const pack_list<view_type>& list, Kokkos::View<double*>& rcv_buffer, int depth);
 
 #endif
 
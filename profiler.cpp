@@ -0,0 +1,222 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under 
+ the terms of the GNU General Public License as published by the 
+ Free Software Foundation, either version 3 of the License, or (at your option) 
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but 
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+//  @brief Internal code profiler
+//  @details Every profiled section of the code is also a Kokkos profiling
+//  region, so external Kokkos tools report the same breakdown as the internal
+//  profiler. Kernel launches return before the kernel has run on asynchronous
+//  backends, so when the internal profiler is on the device is fenced at both
+//  ends of a section and its time is charged to the section that launched the
+//  work. With the profiler off no fences are issued.
+//  At the end of the run the counters of every task are gathered on the boss,
+//  which reports them along with their spread across tasks.
+//  The load balancer also reads the counters, so the sections are timed
+//  whenever it is on, even with the profiler report off.
+
+#include "profiler.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <vector>
+
+extern std::ostream g_out;
+
+// The profiled sections, in the order they are reported
+struct profiler_entry {
+  const char *name;
+  const char *label;
+  double profiler_type::*counter;
+};
+
+static const profiler_entry profiler_entries[] = {
+  {"timestep",           "Timestep              :", &profiler_type::timestep},
+  {"timestep_reduction", "Timestep Reduction    :", &profiler_type::timestep_reduction},
+  {"ideal_gas",          "Ideal Gas             :", &profiler_type::ideal_gas},
+  {"viscosity",          "Viscosity             :", &profiler_type::viscosity},
+  {"PdV",                "PdV                   :", &profiler_type::PdV},
+  {"revert",             "Revert                :", &profiler_type::revert},
+  {"acceleration",       "Acceleration          :", &profiler_type::acceleration},
+  {"flux",               "Fluxes                :", &profiler_type::flux},
+  {"cell_advection",     "Cell Advection        :", &profiler_type::cell_advection},
+  {"mom_advection",      "Momentum Advection    :", &profiler_type::mom_advection},
+  {"reset",              "Reset                 :", &profiler_type::reset},
+  {"summary",            "Summary               :", &profiler_type::summary},
+  {"visit",              "Visit                 :", &profiler_type::visit},
+  {"tile_halo_exchange", "Tile Halo Exchange    :", &profiler_type::tile_halo_exchange},
+  {"self_halo_exchange", "Self Halo Exchange    :", &profiler_type::self_halo_exchange},
+  {"mpi_halo_exchange",  "MPI Halo Exchange     :", &profiler_type::mpi_halo_exchange}
+};
+
+static const int num_profiler_entries = sizeof(profiler_entries)/sizeof(profiler_entries[0]);
+
+static bool profiler_timing(global_variables& globals) {
+
+  return globals.profiler_on || globals.balance_frequency != 0;
+}
+
+//  @brief Opens a profiled section of the code.
+//  @details Returns the start time for profiler_stop, which is only
+//  meaningful when the profiler is on.
+double profiler_start(global_variables& globals, const char *region) {
+
+  Kokkos::Profiling::pushRegion(region);
+
+  if (!profiler_timing(globals)) return 0.0;
+
+  Kokkos::fence();
+  return timer();
+}
+
+//  @brief Closes a profiled section of the code.
+//  @details Adds the time since the matching profiler_start to counter once
+//  all the work launched in the section has completed.
+void profiler_stop(global_variables& globals, double& counter, const double start) {
+
+  if (profiler_timing(globals)) {
+    Kokkos::fence();
+    counter += timer() - start;
+  }
+
+  Kokkos::Profiling::popRegion();
+}
+
+//  @brief Time the task has spent computing.
+//  @details The sum of the counters of the sections of the hydro step that
+//  do not wait on other tasks. The timestep reduction and the MPI halo
+//  exchange wait for the other tasks, so both are left out, as are the
+//  summary and visit output.
+double profiler_compute_time(global_variables& globals) {
+
+  const profiler_type& p = globals.profiler;
+  return p.timestep + p.ideal_gas + p.viscosity + p.PdV + p.revert + p.acceleration + p.flux
+    + p.cell_advection + p.mom_advection + p.reset + p.tile_halo_exchange + p.self_halo_exchange;
+}
+
+
+//  @brief Reports the profiler counters of all tasks.
+//  @details Gathers every counter from every task in one collective. The
+//  classic table is printed for the task with the largest total, which
+//  seems to work better than adding up the maximum time of each kernel; that
+//  always gives over 100% as it does not take into account compute overlaps
+//  before synchronisations caused by halo exchanges. The minimum, mean and
+//  maximum of each counter over the tasks follow, with the imbalance
+//  (maximum over mean) and the slowest task, and the same data along with the
+//  time of every task is written to clover_profile.csv.
+void profiler_report(global_variables& globals, parallel_& parallel, const double wall_clock) {
+
+  // One row per task, with the total of the task in the last column
+  const int row = num_profiler_entries+1;
+
+  std::vector<double> counters(row);
+  double kernel_total = 0.0;
+  for (int e = 0; e < num_profiler_entries; ++e) {
+    counters[e] = globals.profiler.*profiler_entries[e].counter;
+    kernel_total += counters[e];
+  }
+  counters[num_profiler_entries] = kernel_total;
+
+  std::vector<double> totals;
+  if (parallel.boss) totals.resize(row*parallel.max_task);
+
+  clover_gather(counters.data(), row, totals.data());
+
+  if (!parallel.boss) return;
+
+  std::vector<double> minimum(row), mean(row), maximum(row), imbalance(row);
+  std::vector<int> slowest(row);
+  for (int e = 0; e < row; ++e) {
+    minimum[e] = std::numeric_limits<double>::max();
+    maximum[e] = -1.0;
+    mean[e] = 0.0;
+    for (int task = 0; task < parallel.max_task; ++task) {
+      double t = totals[task*row+e];
+      minimum[e] = std::min(minimum[e], t);
+      mean[e] += t;
+      if (t >= maximum[e]) {
+        maximum[e] = t;
+        slowest[e] = task;
+      }
+    }
+    mean[e] /= parallel.max_task;
+    imbalance[e] = (mean[e] > 0.0) ? maximum[e]/mean[e] : 1.0;
+  }
+
+  // Individual kernel times of the task with the largest total
+  const int loc = slowest[num_profiler_entries];
+  const double *profile = &totals[loc*row];
+  kernel_total = profile[num_profiler_entries];
+
+  g_out << std::endl
+    << "Profiler Output                 Time            Percentage" << std::endl;
+  for (int e = 0; e < num_profiler_entries; ++e) {
+    g_out << profiler_entries[e].label << profile[e] << " "
+      << 100.0*(profile[e]/wall_clock) << std::endl;
+  }
+  g_out
+    << "Total                 :" << kernel_total << " "
+        << 100.0*(kernel_total/wall_clock) << std::endl
+    << "The Rest              :" << wall_clock-kernel_total << " "
+        << 100.0*(wall_clock-kernel_total)/wall_clock << std::endl
+    << std::endl;
+
+  auto formatting = g_out.flags();
+  g_out
+    << "Profiler Balance over " << parallel.max_task << " tasks" << std::endl
+    << "                        "
+    << "Minimum        "
+    << "Mean           "
+    << "Maximum        "
+    << "Imbalance      "
+    << "Slowest task" << std::endl;
+  for (int e = 0; e < row; ++e) {
+    g_out
+      << (e < num_profiler_entries ? profiler_entries[e].label : "Total                 :")
+      << std::scientific << std::setprecision(6)
+      << std::setw(15) << std::left << minimum[e]
+      << std::setw(15) << std::left << mean[e]
+      << std::setw(15) << std::left << maximum[e]
+      << std::fixed << std::setprecision(3)
+      << std::setw(15) << std::left << imbalance[e]
+      << slowest[e] << std::endl;
+  }
+  g_out << std::endl;
+  g_out.flags(formatting);
+
+  std::ofstream csv("clover_profile.csv");
+  if (!csv.is_open()) {
+    g_out << "Unable to open clover_profile.csv, the per task profile was not written" << std::endl;
+    return;
+  }
+
+  csv << std::setprecision(std::numeric_limits<double>::max_digits10);
+  csv << "kernel,min,mean,max,imbalance,slowest_task";
+  for (int task = 0; task < parallel.max_task; ++task) csv << ",task_" << task;
+  csv << std::endl;
+  for (int e = 0; e < row; ++e) {
+    csv << (e < num_profiler_entries ? profiler_entries[e].name : "total") << ","
+      << minimum[e] << "," << mean[e] << "," << maximum[e] << "," << imbalance[e] << "," << slowest[e];
+    for (int task = 0; task < parallel.max_task; ++task) csv << "," << totals[task*row+e];
+    csv << std::endl;
+  }
+}
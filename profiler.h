@@ -0,0 +1,34 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under 
+ the terms of the GNU General Public License as published by the 
+ Free Software Foundation, either version 3 of the License, or (at your option) 
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but 
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "definitions.h"
+#include "comms.h"
+
+double profiler_start(global_variables& globals, const char *region);
+void profiler_stop(global_variables& globals, double& counter, const double start);
+double profiler_compute_time(global_variables& globals);
+void profiler_report(global_variables& globals, parallel_& parallel, const double wall_clock);
+
+#endif
+
@@ -27,6 +27,7 @@
 #include "read_input.h"
 
 #include "report.h"
+#include "temporal_block.h"
 
 #include <iostream>
 #include <cstring>
@@ -55,8 +56,29 @@ void read_input(std::ifstream& g_in, parallel_& parallel, global_variables& glob
 
   globals.visit_frequency = 0;
   globals.summary_frequency = 10;
+  globals.balance_frequency = 0;
+  globals.balance_tolerance = 0.05;
 
+  globals.number_of_chunks = parallel.max_task;
   globals.tiles_per_chunk = 1;
+  int tiles_per_problem = 0;
+  globals.tile_concurrency = 1;
+  globals.tile_cache_bytes = 0;
+
+  globals.field_padding = 0;
+
+  globals.fused_timestep = false;
+  globals.fused_advec_cell = false;
+  globals.fused_advec_mom = false;
+
+  globals.overlap_halo = false;
+  globals.exchange_corners = false;
+  globals.halo_depth = 2;
+  globals.cartesian_topology = false;
+  globals.neighbour_exchange = false;
+  globals.shared_exchange = false;
+  globals.nonblocking_reductions = false;
+  globals.temporal_blocking = false;
 
   globals.dtinit = 0.1;
   globals.dtmax = 1.0;
@@ -69,6 +91,7 @@ void read_input(std::ifstream& g_in, parallel_& parallel, global_variables& glob
 
   globals.profiler_on = false;
   globals.profiler.timestep = 0.0;
+  globals.profiler.timestep_reduction = 0.0;
   globals.profiler.acceleration = 0.0;
   globals.profiler.PdV = 0.0;
   globals.profiler.cell_advection = 0.0;
@@ -192,13 +215,86 @@ void read_input(std::ifstream& g_in, parallel_& parallel, global_variables& glob
       globals.summary_frequency = std::atoi(words[1].c_str());
       if (parallel.boss) g_out << " summary_frequency " << globals.summary_frequency << std::endl;
     }
+    else if (words[0] == "balance_frequency") {
+      globals.balance_frequency = std::atoi(words[1].c_str());
+      if (parallel.boss) g_out << " balance_frequency " << globals.balance_frequency << std::endl;
+    }
+    else if (words[0] == "balance_tolerance") {
+      globals.balance_tolerance = std::atof(words[1].c_str());
+      if (parallel.boss) g_out << " balance_tolerance " << globals.balance_tolerance << std::endl;
+    }
+    else if (words[0] == "number_of_chunks") {
+      globals.number_of_chunks = std::atoi(words[1].c_str());
+      if (parallel.boss) g_out << " number_of_chunks " << globals.number_of_chunks << std::endl;
+    }
+    else if (words[0] == "chunks_per_task") {
+      globals.number_of_chunks = std::atoi(words[1].c_str())*parallel.max_task;
+      if (parallel.boss) g_out << " number_of_chunks " << globals.number_of_chunks << std::endl;
+    }
     else if (words[0] == "tiles_per_chunk") {
       globals.tiles_per_chunk = std::atoi(words[1].c_str());
       if (parallel.boss) g_out << " tiles_per_chunk " << globals.tiles_per_chunk << std::endl;
     }
+    else if (words[0] == "tile_concurrency") {
+      globals.tile_concurrency = std::atoi(words[1].c_str());
+      if (parallel.boss) g_out << " tile_concurrency " << globals.tile_concurrency << std::endl;
+    }
+    else if (words[0] == "tile_cache_kb") {
+      globals.tile_cache_bytes = std::atol(words[1].c_str())*1024;
+      if (parallel.boss) g_out << " tile_cache_kb " << globals.tile_cache_bytes/1024 << std::endl;
+    }
+    else if (words[0] == "field_padding") {
+      globals.field_padding = std::atoi(words[1].c_str());
+      if (parallel.boss) g_out << " field_padding " << globals.field_padding << std::endl;
+    }
     else if (words[0] == "tiles_per_problem") {
-      globals.tiles_per_chunk = std::atoi(words[1].c_str())/parallel.max_task;
-      if (parallel.boss) g_out << " tiles_per_chunk " << globals.tiles_per_chunk << std::endl;
+      tiles_per_problem = std::atoi(words[1].c_str());
+      if (parallel.boss) g_out << " tiles_per_problem " << tiles_per_problem << std::endl;
+    }
+    else if (words[0] == "fused_timestep") {
+      globals.fused_timestep = true;
+      if (parallel.boss) g_out << " Fused timestep" << std::endl;
+    }
+    else if (words[0] == "fused_advec_cell") {
+      globals.fused_advec_cell = true;
+      if (parallel.boss) g_out << " Fused cell advection" << std::endl;
+    }
+    else if (words[0] == "fused_advec_mom") {
+      globals.fused_advec_mom = true;
+      if (parallel.boss) g_out << " Fused momentum advection" << std::endl;
+    }
+    else if (words[0] == "overlap_halo") {
+      globals.overlap_halo = true;
+      if (parallel.boss) g_out << " Halo exchange overlapped with computation" << std::endl;
+    }
+    else if (words[0] == "exchange_corners") {
+      globals.exchange_corners = true;
+      if (parallel.boss) g_out << " Single phase halo exchange with corner neighbours" << std::endl;
+    }
+    else if (words[0] == "cartesian_topology") {
+      globals.cartesian_topology = true;
+      if (parallel.boss) g_out << " Halo exchange on a Cartesian communicator" << std::endl;
+    }
+    else if (words[0] == "neighbour_exchange") {
+      globals.cartesian_topology = true;
+      globals.neighbour_exchange = true;
+      if (parallel.boss) g_out << " Halo exchange by neighbourhood collectives" << std::endl;
+    }
+    else if (words[0] == "shared_exchange") {
+      globals.shared_exchange = true;
+      if (parallel.boss) g_out << " Halo exchange through shared memory on the node" << std::endl;
+    }
+    else if (words[0] == "nonblocking_reductions") {
+      globals.nonblocking_reductions = true;
+      if (parallel.boss) g_out << " Non-blocking timestep reduction" << std::endl;
+    }
+    else if (words[0] == "temporal_blocking") {
+      globals.temporal_blocking = true;
+      if (parallel.boss) g_out << " Temporal blocking of the hydro phases on each tile" << std::endl;
+    }
+    else if (words[0] == "halo_depth") {
+      globals.halo_depth = std::atoi(words[1].c_str());
+      if (parallel.boss) g_out << " halo_depth " << globals.halo_depth << std::endl;
     }
     else if (words[0] == "profiler_on") {
       globals.profiler_on = true;
@@ -284,6 +380,29 @@ void read_input(std::ifstream& g_in, parallel_& parallel, global_variables& glob
     g_out << std::endl;
   }
 
+  // The tiles of the problem are shared between the chunks, however many
+  // there are
+  if (tiles_per_problem > 0) globals.tiles_per_chunk = tiles_per_problem/globals.number_of_chunks;
+
+  if (globals.tile_concurrency < 1) report_error((char *)"read_input", (char *)"tile_concurrency must be at least 1.");
+  if (globals.halo_depth < 2) report_error((char *)"read_input", (char *)"halo_depth must be at least 2.");
+  if (globals.number_of_chunks < parallel.max_task) {
+    report_error((char *)"read_input", (char *)"number_of_chunks must be at least the number of tasks.");
+  }
+  if (globals.number_of_chunks > parallel.max_task &&
+      (globals.cartesian_topology || globals.neighbour_exchange || globals.shared_exchange || globals.balance_frequency != 0)) {
+    report_error((char *)"read_input", (char *)"cartesian_topology, neighbour_exchange, shared_exchange and balance_frequency need one chunk per task.");
+  }
+  if (globals.shared_exchange && globals.neighbour_exchange) {
+    report_error((char *)"read_input", (char *)"shared_exchange cannot be combined with neighbour_exchange.");
+  }
+  if (globals.temporal_blocking && globals.halo_depth < g_block_depth) {
+    report_error((char *)"read_input", (char *)"temporal_blocking needs a halo_depth of at least 8.");
+  }
+  if (globals.temporal_blocking && (globals.fused_timestep || globals.overlap_halo)) {
+    report_error((char *)"read_input", (char *)"temporal_blocking cannot be combined with fused_timestep or overlap_halo.");
+  }
+
   if (parallel.boss) {
     g_out << std::endl << std::endl
       << "Input read finished." << std::endl
@@ -19,69 +19,31 @@
 
 
 #include "reset_field.h"
-#include "timer.h"
-
-//  @brief Fortran reset field kernel.
-//  @author Wayne Gaudin
-//  @details Copies all of the final end of step filed data to the begining of
-//  step data, ready for the next timestep.
-void reset_field_kernel(
-  int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& yvel1) {
-
-  // DO k=y_min,y_max
-  //   DO j=x_min,x_max
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy1({x_min+1, y_min+1}, {x_max+2, y_max+2});
-  Kokkos::parallel_for("reset_field_1", policy1, KOKKOS_LAMBDA (const int j, const int k) {
-
-    density0(j,k)=density1(j,k);
-    energy0(j,k)=energy1(j,k);
-
-  });
-
-  // DO k=y_min,y_max+1
-  //   DO j=x_min,x_max+1
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy2({x_min+1, y_min+1}, {x_max+1+2, y_max+1+2});
-  Kokkos::parallel_for("reset_field_2", policy2, KOKKOS_LAMBDA (const int j, const int k) {
-    xvel0(j,k) = xvel1(j,k);
-    yvel0(j,k) = yvel1(j,k);
-  });
-
-}
+#include "profiler.h"
 
+#include <utility>
 
 //  @brief Reset field driver
 //  @author Wayne Gaudin
-//  @details Invokes the user specified field reset kernel.
+//  @details Makes the end of step field data the start of step data, ready
+//  for the next timestep. The two time levels are swapped by handle rather
+//  than copied, so no field data moves.
+//  The old start of step data becomes the end of step storage. Every step
+//  overwrites its owned cells and nodes before reading them, and exchanges its
+//  halos before advection. The halos of the new start of step data are
+//  refreshed by the exchange in timestep before they are read.
 void reset_field(global_variables& globals) {
 
-  double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
+  double kernel_time = profiler_start(globals, "reset");
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
 
-    reset_field_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.tiles[tile].field.energy1,
-      globals.chunk.tiles[tile].field.xvel0,
-      globals.chunk.tiles[tile].field.xvel1,
-      globals.chunk.tiles[tile].field.yvel0,
-      globals.chunk.tiles[tile].field.yvel1);
+    std::swap(globals.tiles[tile].field.density0, globals.tiles[tile].field.density1);
+    std::swap(globals.tiles[tile].field.energy0, globals.tiles[tile].field.energy1);
+    std::swap(globals.tiles[tile].field.xvel0, globals.tiles[tile].field.xvel1);
+    std::swap(globals.tiles[tile].field.yvel0, globals.tiles[tile].field.yvel1);
   }
 
-    if (globals.profiler_on) globals.profiler.reset += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.reset, kernel_time);
 }
 
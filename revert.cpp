@@ -27,15 +27,16 @@
 //  Note that this does not seem necessary in this proxy-app but should be
 //  left in to remain relevant to the full method.
 void revert_kernel(
+  const exec_space& space,
   int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& energy1) {
+  field_view& density0,
+  field_view& density1,
+  field_view& energy0,
+  field_view& energy1) {
 
   // DO k=y_min,y_max
   //   DO j=x_min,x_max
-  Kokkos::MDRangePolicy<Kokkos::Rank<2>> policy({x_min+1, y_min+1}, {x_max+2, y_max+2});
+  field_policy policy(space, {x_min+1, y_min+1}, {x_max+2, y_max+2});
 
   Kokkos::parallel_for("revert", policy, KOKKOS_LAMBDA (const int j, const int k) {
 
@@ -52,17 +53,18 @@ void revert_kernel(
 //  @details Invokes the user specified revert kernel.
 void revert(global_variables& globals) {
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
 
     revert_kernel(
-      globals.chunk.tiles[tile].t_xmin,
-      globals.chunk.tiles[tile].t_xmax,
-      globals.chunk.tiles[tile].t_ymin,
-      globals.chunk.tiles[tile].t_ymax,
-      globals.chunk.tiles[tile].field.density0,
-      globals.chunk.tiles[tile].field.density1,
-      globals.chunk.tiles[tile].field.energy0,
-      globals.chunk.tiles[tile].field.energy1);
+      globals.tiles[tile].space,
+      globals.tiles[tile].t_xmin,
+      globals.tiles[tile].t_xmax,
+      globals.tiles[tile].t_ymin,
+      globals.tiles[tile].t_ymax,
+      globals.tiles[tile].field.density0,
+      globals.tiles[tile].field.density1,
+      globals.tiles[tile].field.energy0,
+      globals.tiles[tile].field.energy1);
   }
 }
 
@@ -0,0 +1,106 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under 
+ the terms of the GNU General Public License as published by the 
+ Free Software Foundation, either version 3 of the License, or (at your option) 
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but 
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+//  @brief Scratch array manager
+//  @details The kernels need full-size temporary arrays whose contents do
+//  not outlive a phase of the step. Each temporary is given the span of the
+//  step over which it is live. They are then packed into as few shared
+//  buffers as possible, so only the arrays actually needed by the selected
+//  kernels are allocated.
+
+#include "scratch.h"
+
+// Points in the step at which temporaries are live, in step order
+enum scratch_point {
+  point_cell_advection = 0,
+  point_mom_advection  = 1
+};
+
+// Record that a temporary is live from first to last inclusive
+static void scratch_live(int first[NUM_SCRATCH], int last[NUM_SCRATCH], scratch_name name, int from, int to) {
+  first[name] = from;
+  last[name] = to;
+}
+
+//  @brief Maps the scratch temporaries onto buffers
+//  @details Two temporaries may share a buffer if their live spans do not
+//  overlap. Taking them in order of first use and giving each the first
+//  buffer that is free again uses the fewest buffers possible. Must be called
+//  after the input is read and before the fields are built.
+void scratch_plan(global_variables& globals) {
+
+  int first[NUM_SCRATCH], last[NUM_SCRATCH];
+  for (int name = 0; name < NUM_SCRATCH; ++name) {
+    first[name] = -1;
+    last[name] = -1;
+  }
+
+  // Cell advection; the fused kernel recomputes the volumes instead
+  if (!globals.fused_advec_cell) {
+    scratch_live(first, last, scratch_cell_pre_vol, point_cell_advection, point_cell_advection);
+    scratch_live(first, last, scratch_cell_post_vol, point_cell_advection, point_cell_advection);
+  }
+  scratch_live(first, last, scratch_ener_flux, point_cell_advection, point_cell_advection);
+
+  // Momentum advection; the node arrays are shared by both velocities
+  scratch_live(first, last, scratch_node_flux, point_mom_advection, point_mom_advection);
+  scratch_live(first, last, scratch_node_mass_post, point_mom_advection, point_mom_advection);
+  scratch_live(first, last, scratch_node_mass_pre, point_mom_advection, point_mom_advection);
+  scratch_live(first, last, scratch_mom_flux, point_mom_advection, point_mom_advection);
+  if (globals.fused_advec_mom) {
+    scratch_live(first, last, scratch_ymom_flux, point_mom_advection, point_mom_advection);
+  }
+  else {
+    scratch_live(first, last, scratch_mom_pre_vol, point_mom_advection, point_mom_advection);
+    scratch_live(first, last, scratch_mom_post_vol, point_mom_advection, point_mom_advection);
+  }
+
+  // Last point at which each buffer is in use
+  int buffer_last[NUM_SCRATCH];
+  globals.scratch_count = 0;
+
+  for (int point = point_cell_advection; point <= point_mom_advection; ++point) {
+    for (int name = 0; name < NUM_SCRATCH; ++name) {
+      if (first[name] != point) continue;
+
+      int buffer = 0;
+      while (buffer < globals.scratch_count && buffer_last[buffer] >= first[name]) ++buffer;
+      if (buffer == globals.scratch_count) ++globals.scratch_count;
+
+      buffer_last[buffer] = last[name];
+      globals.scratch_map[name] = buffer;
+    }
+  }
+
+  for (int name = 0; name < NUM_SCRATCH; ++name) {
+    if (first[name] < 0) globals.scratch_map[name] = -1;
+  }
+}
+
+//  @brief Buffer holding a scratch temporary on a tile
+//  @details Temporaries not used by the selected kernels get an empty View.
+work_view& scratch(global_variables& globals, int tile, scratch_name name) {
+
+  static work_view unused;
+
+  if (globals.scratch_map[name] < 0) return unused;
+  return globals.tiles[tile].field.scratch[globals.scratch_map[name]];
+}
+
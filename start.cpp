@@ -27,12 +27,14 @@
 
 #include "start.h"
 #include "build_field.h"
+#include "scratch.h"
 #include "initialise_chunk.h"
 #include "generate_chunk.h"
 #include "ideal_gas.h"
 #include "field_summary.h"
 #include "update_halo.h"
 #include "visit.h"
+#include "tile_schedule.h"
 
 extern std::ostream g_out;
 
@@ -50,40 +52,34 @@ void start(parallel_& parallel, global_variables& globals) {
 
   clover_barrier();
 
-  // clover_get_num_chunks()
-  globals.number_of_chunks = parallel.max_task;
+  // Create the chunks, number_of_chunks having been set by read_input
+  clover_decompose(globals, parallel, globals.grid.x_cells, globals.grid.y_cells);
 
-  int left, right, bottom, top;
-  clover_decompose(globals, parallel, globals.grid.x_cells, globals.grid.y_cells, left, right, bottom, top);
-
-  // Create the chunks
-  globals.chunk.task = parallel.task;
-
-  int x_cells = right - left + 1;
-  int y_cells = top - bottom + 1;
-
-  
-  globals.chunk.left    = left;
-  globals.chunk.bottom  = bottom;
-  globals.chunk.right   = right;
-  globals.chunk.top     = top;
-  globals.chunk.left_boundary   = 1;
-  globals.chunk.bottom_boundary = 1;
-  globals.chunk.right_boundary  = globals.grid.x_cells;
-  globals.chunk.top_boundary    = globals.grid.y_cells;
-  globals.chunk.x_min = 1;
-  globals.chunk.y_min = 1;
-  globals.chunk.x_max = x_cells;
-  globals.chunk.y_max = y_cells;
+  // The scratch arrays count towards the storage of a tile when sizing them
+  scratch_plan(globals);
+  tile_size_to_cache(globals, parallel);
 
   // Create the tiles
-  globals.chunk.tiles = new tile_type[globals.tiles_per_chunk];
+  globals.local_tiles = globals.local_chunks*globals.tiles_per_chunk;
+  globals.tiles = new tile_type[globals.local_tiles];
 
-  clover_tile_decompose(globals, x_cells, y_cells);
+  for (int c = 0; c < globals.local_chunks; ++c) {
+    clover_tile_decompose(globals, c);
+  }
 
   // Line 92 start.f90
   build_field(globals);
 
+  if (parallel.boss) {
+    size_t chunk_bytes = 0;
+    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
+      g_out << "Tile " << tile << " field storage " << globals.tiles[tile].field_bytes << " bytes" << std::endl;
+      chunk_bytes += globals.tiles[tile].field_bytes;
+    }
+    g_out << "Chunk field storage " << chunk_bytes << " bytes, including " << globals.scratch_count << " scratch arrays per tile" << std::endl;
+    g_out << "Soundspeed, viscosity and scratch arrays stored in " << (sizeof(work_type) == sizeof(float) ? "float" : "double") << std::endl << std::endl;
+  }
+
   clover_barrier();
 
   clover_allocate_buffers(globals, parallel);
@@ -92,22 +88,27 @@ void start(parallel_& parallel, global_variables& globals) {
     g_out << "Generating chunks" << std::endl;
   }
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
     initialise_chunk(tile, globals);
     generate_chunk(tile, globals);
   }
 
+  // The hydro kernels of each tile run on its partition from here
+  tile_spaces(globals, parallel);
+
   globals.advect_x = true;
 
   clover_barrier();
 
   // Do no profile the start up costs otherwise the total times will not add up
-  // at the end
+  // at the end. The load balancer still times the sections, so the counters
+  // are put back as well.
   bool profiler_off = globals.profiler_on;
   globals.profiler_on = false;
+  profiler_type start_profile = globals.profiler;
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    ideal_gas(globals, tile, false, 0);
   }
 
   // Prime all halo data for the first step
@@ -126,7 +127,7 @@ void start(parallel_& parallel, global_variables& globals) {
   fields[field_xvel1]     = 1;
   fields[field_yvel1]     = 1;
 
-  update_halo(globals, fields, 2);
+  update_halo(globals, fields, globals.halo_depth);
 
   if (parallel.boss) {
     g_out << std::endl
@@ -140,6 +141,7 @@ void start(parallel_& parallel, global_variables& globals) {
   clover_barrier();
 
   globals.profiler_on = profiler_off;
+  globals.profiler = start_profile;
 
 }
 
@@ -0,0 +1,173 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under 
+ the terms of the GNU General Public License as published by the 
+ Free Software Foundation, either version 3 of the License, or (at your option) 
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but 
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Temporally blocked hydro step
+//  @details Runs the PdV predictor, acceleration, PdV corrector, flux
+//  calculation and both advection sweeps on one tile before moving to the
+//  next, from the single exchange made by the timestep. Each phase is run
+//  over the tile and a ring of its halo wide enough for the phases after it,
+//  so none of the halo exchanges between the phases is needed. The halos on
+//  the external faces are still updated by the reflective boundary, which
+//  reads only the tile's own cells. The extra work on the rings buys fields
+//  that stay in cache from one phase to the next and one message per step.
+
+#include "temporal_block.h"
+#include "PdV.h"
+#include "ideal_gas.h"
+#include "accelerate.h"
+#include "flux_calc.h"
+#include "advec_cell.h"
+#include "advec_mom.h"
+#include "update_halo.h"
+#include "profiler.h"
+#include "tile_schedule.h"
+#include "comms.h"
+#include "report.h"
+
+// Halo cells of each tile computed by each phase. Each ring is what the
+// phases after it read, the advection passes two cells beyond their ring
+// and the others one.
+#define ring_mom_sweep2 0
+#define ring_cell_sweep2 (ring_mom_sweep2+2)
+#define ring_mom_sweep1 ring_cell_sweep2
+#define ring_cell_sweep1 (ring_mom_sweep1+2)
+#define ring_flux (ring_cell_sweep1+2)
+#define ring_corrector ring_flux
+#define ring_accelerate ring_corrector
+#define ring_predictor (ring_accelerate+1)
+
+//  @brief Momentum advection of one tile
+//  @details Advects both velocity components, fused or one at a time.
+static void temporal_block_mom(global_variables& globals, int tile, int direction, int sweep_number, int ring) {
+
+  if (globals.fused_advec_mom) {
+    advec_mom_fused_driver(globals, tile, direction, sweep_number, ring);
+  }
+  else {
+    advec_mom_driver(globals, tile, g_xdir, direction, sweep_number, ring);
+    advec_mom_driver(globals, tile, g_ydir, direction, sweep_number, ring);
+  }
+}
+
+void temporal_block(global_variables& globals) {
+
+  int direction1, direction2;
+  if (globals.advect_x) {
+    direction1 = g_xdir;
+    direction2 = g_ydir;
+  }
+  else {
+    direction1 = g_ydir;
+    direction2 = g_xdir;
+  }
+
+  int pressure_fields[NUM_FIELDS];
+  int flux_fields[NUM_FIELDS];
+  int advected_fields[NUM_FIELDS];
+  for (int i = 0; i < NUM_FIELDS; ++i) {
+    pressure_fields[i] = 0;
+    flux_fields[i] = 0;
+    advected_fields[i] = 0;
+  }
+  pressure_fields[field_pressure] = 1;
+  flux_fields[field_density1] = 1;
+  flux_fields[field_energy1] = 1;
+  flux_fields[field_xvel1] = 1;
+  flux_fields[field_yvel1] = 1;
+  flux_fields[field_vol_flux_x] = 1;
+  flux_fields[field_vol_flux_y] = 1;
+  advected_fields[field_density1] = 1;
+  advected_fields[field_energy1] = 1;
+  advected_fields[field_xvel1] = 1;
+  advected_fields[field_yvel1] = 1;
+  advected_fields[field_mass_flux_x] = 1;
+  advected_fields[field_mass_flux_y] = 1;
+
+  globals.error_condition = 0;
+
+  tile_fence(globals);
+
+  double kernel_time;
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+
+    kernel_time = profiler_start(globals, "PdV");
+    PdV_tile(globals, tile, true, ring_predictor);
+    profiler_stop(globals, globals.profiler.PdV, kernel_time);
+
+    kernel_time = profiler_start(globals, "ideal_gas");
+    ideal_gas(globals, tile, true, ring_predictor);
+    profiler_stop(globals, globals.profiler.ideal_gas, kernel_time);
+
+    kernel_time = profiler_start(globals, "self_halo_exchange");
+    update_halo_reflect_tile(globals, tile, pressure_fields, g_block_depth);
+    profiler_stop(globals, globals.profiler.self_halo_exchange, kernel_time);
+
+    // No revert is needed, as the corrector recomputes time level 1 from
+    // time level 0 on every cell read after it
+
+    kernel_time = profiler_start(globals, "acceleration");
+    accelerate_tile(globals, tile, ring_accelerate);
+    profiler_stop(globals, globals.profiler.acceleration, kernel_time);
+
+    kernel_time = profiler_start(globals, "PdV");
+    PdV_tile(globals, tile, false, ring_corrector);
+    profiler_stop(globals, globals.profiler.PdV, kernel_time);
+
+    kernel_time = profiler_start(globals, "flux");
+    flux_calc_tile(globals, tile, ring_flux);
+    profiler_stop(globals, globals.profiler.flux, kernel_time);
+
+    kernel_time = profiler_start(globals, "self_halo_exchange");
+    update_halo_reflect_tile(globals, tile, flux_fields, g_block_depth);
+    profiler_stop(globals, globals.profiler.self_halo_exchange, kernel_time);
+
+    kernel_time = profiler_start(globals, "cell_advection");
+    advec_cell_driver(globals, tile, 1, direction1, overlap_all, ring_cell_sweep1);
+    profiler_stop(globals, globals.profiler.cell_advection, kernel_time);
+
+    kernel_time = profiler_start(globals, "self_halo_exchange");
+    update_halo_reflect_tile(globals, tile, advected_fields, g_block_depth);
+    profiler_stop(globals, globals.profiler.self_halo_exchange, kernel_time);
+
+    kernel_time = profiler_start(globals, "mom_advection");
+    temporal_block_mom(globals, tile, direction1, 1, ring_mom_sweep1);
+    profiler_stop(globals, globals.profiler.mom_advection, kernel_time);
+
+    kernel_time = profiler_start(globals, "cell_advection");
+    advec_cell_driver(globals, tile, 2, direction2, overlap_all, ring_cell_sweep2);
+    profiler_stop(globals, globals.profiler.cell_advection, kernel_time);
+
+    kernel_time = profiler_start(globals, "self_halo_exchange");
+    update_halo_reflect_tile(globals, tile, advected_fields, g_block_depth);
+    profiler_stop(globals, globals.profiler.self_halo_exchange, kernel_time);
+
+    kernel_time = profiler_start(globals, "mom_advection");
+    temporal_block_mom(globals, tile, direction2, 2, ring_mom_sweep2);
+    profiler_stop(globals, globals.profiler.mom_advection, kernel_time);
+
+  }
+
+  tile_fence(globals);
+
+  clover_check_error(globals.error_condition);
+  if (globals.error_condition == 1) {
+    report_error((char *)"PdV", (char *)"error in PdV");
+  }
+}
+
@@ -0,0 +1,34 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under 
+ the terms of the GNU General Public License as published by the 
+ Free Software Foundation, either version 3 of the License, or (at your option) 
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but 
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef TEMPORAL_BLOCK_H
+#define TEMPORAL_BLOCK_H
+
+#include "definitions.h"
+
+// Halo depth exchanged once per step when the hydro phases are blocked. Each
+// advection pass reads two cells beyond those it updates, and the phases
+// before it one more, so counting back from the second momentum sweep over
+// the tile itself the equation of state of time level 0 needs 8 cells.
+#define g_block_depth 8
+
+void temporal_block(global_variables& globals);
+
+#endif
+
@@ -0,0 +1,155 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under 
+ the terms of the GNU General Public License as published by the 
+ Free Software Foundation, either version 3 of the License, or (at your option) 
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but 
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+//  @brief Tile scheduler
+//  @details Sizes the tiles so that the fields of one fit in a cache, and
+//  spreads the tiles over partitions of the execution space. A driver runs
+//  all of its kernels on a tile before moving to the next, so with tiles that
+//  fit in cache the later kernels find the data of the earlier ones still
+//  resident. Tiles on different partitions run concurrently, the kernels of
+//  each tile in order on its own partition.
+
+#include "tile_schedule.h"
+#include "build_field.h"
+
+#include <vector>
+
+extern std::ostream g_out;
+
+//  @brief Chooses the tiles per chunk from the cache size
+//  @details Tries tile counts upwards from the number of cache sized pieces
+//  in the largest chunk, the first estimate being short by the halo of each
+//  tile. Of the counts whose largest tile fits, up to twice the first that
+//  does, the one with the least storage in total is taken. It has the least
+//  halo, which rules out the thin strips of prime counts. Counts leaving a
+//  tile narrower than the halo are skipped, and if no count fits the one
+//  with the smallest tiles is taken. Every task takes the largest count any
+//  task needs, as the count is the same on all of them.
+void tile_size_to_cache(global_variables& globals, parallel_& parallel) {
+
+  if (globals.tile_cache_bytes == 0) return;
+
+  int c = 0;
+  for (int i = 1; i < globals.local_chunks; ++i) {
+    if (globals.chunks[i].x_max*globals.chunks[i].y_max > globals.chunks[c].x_max*globals.chunks[c].y_max) c = i;
+  }
+  chunk_type& chunk = globals.chunks[c];
+
+  const int h = globals.halo_depth;
+  const size_t chunk_bytes = tile_field_bytes(globals, h-1, h-2+chunk.x_max, h-1, h-2+chunk.y_max);
+
+  const int most = MAX(1, (chunk.x_max/h)*(chunk.y_max/h));
+  const int estimate = (int)MIN((size_t)most, (chunk_bytes+globals.tile_cache_bytes-1)/globals.tile_cache_bytes);
+
+  int best = 0;
+  int first_fit = 0;
+  size_t best_total = 0;
+  int finest = 1;
+  size_t finest_largest = chunk_bytes;
+  for (int count = estimate; count <= MIN(most, 4*estimate); ++count) {
+    if (first_fit != 0 && count > 2*first_fit) break;
+
+    globals.tiles_per_chunk = count;
+    int tile_x, tile_y;
+    clover_tile_split(globals, c, tile_x, tile_y);
+    const int delta_x = chunk.x_max/tile_x;
+    const int delta_y = chunk.y_max/tile_y;
+    if (delta_x < h || delta_y < h) continue;
+
+    // As in clover_tile_decompose, the first x_max%tile_x tiles in x are a
+    // cell wider than the rest, and likewise in y
+    size_t largest = 0;
+    size_t total = 0;
+    for (int ty = 1; ty <= tile_y; ++ty) {
+      for (int tx = 1; tx <= tile_x; ++tx) {
+        const int width = delta_x+(tx <= chunk.x_max%tile_x ? 1 : 0);
+        const int height = delta_y+(ty <= chunk.y_max%tile_y ? 1 : 0);
+        const size_t bytes = tile_field_bytes(globals, h-1, h-2+width, h-1, h-2+height);
+        largest = MAX(largest, bytes);
+        total += bytes;
+      }
+    }
+
+    if (largest < finest_largest) {
+      finest = count;
+      finest_largest = largest;
+    }
+    if (largest > globals.tile_cache_bytes) continue;
+
+    if (first_fit == 0) first_fit = count;
+    if (best == 0 || total < best_total) {
+      best = count;
+      best_total = total;
+    }
+  }
+
+  // When no tiling fits, the one with the smallest tiles comes closest
+  if (best == 0) best = finest;
+
+  std::vector<double> counts(parallel.max_task);
+  clover_allgather((double)best, counts.data());
+  for (int task = 0; task < parallel.max_task; ++task) best = MAX(best, (int)counts[task]);
+  globals.tiles_per_chunk = best;
+  for (int i = 0; i < globals.local_chunks; ++i) {
+    globals.chunks[i].first_tile = i*globals.tiles_per_chunk;
+  }
+
+  if (parallel.boss) {
+    g_out << "Tiles sized to a " << globals.tile_cache_bytes/1024 << " kB cache, "
+      << globals.tiles_per_chunk << " tiles per chunk" << std::endl;
+  }
+}
+
+//  @brief Spreads the tiles over partitions of the execution space
+//  @details The execution space is split into tile_concurrency equal
+//  partitions, and the tiles dealt out to them in turn. With one partition,
+//  or a Kokkos too old to partition, every tile keeps the default instance.
+void tile_spaces(global_variables& globals, parallel_& parallel) {
+
+  if (globals.tile_concurrency == 1) return;
+
+#if KOKKOS_VERSION >= 40000
+  std::vector<int> weights(globals.tile_concurrency, 1);
+  std::vector<exec_space> spaces = Kokkos::Experimental::partition_space(exec_space(), weights);
+
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    globals.tiles[tile].space = spaces[tile%globals.tile_concurrency];
+  }
+
+  // The set up ran on the default instance
+  Kokkos::fence("tile_spaces");
+  if (parallel.boss) g_out << "Tiles spread over " << globals.tile_concurrency << " execution space partitions" << std::endl;
+#else
+  globals.tile_concurrency = 1;
+  if (parallel.boss) g_out << "tile_concurrency needs Kokkos 4.0 or later, tiles run on the default instance" << std::endl;
+#endif
+}
+
+//  @brief Waits for the kernels of every tile
+//  @details Work that reads more than one tile, or a tile from the default
+//  instance, such as the halo exchanges and the summary, must not start
+//  until the tiles are complete. Nor may the tiles continue until it has
+//  finished. With all tiles on the default instance its kernels are already
+//  ordered, and nothing is done.
+void tile_fence(global_variables& globals) {
+
+  if (globals.tile_concurrency > 1) Kokkos::fence("tile_fence");
+}
+
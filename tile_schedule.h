@@ -0,0 +1,32 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under 
+ the terms of the GNU General Public License as published by the 
+ Free Software Foundation, either version 3 of the License, or (at your option) 
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but 
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#ifndef TILE_SCHEDULE_H
+#define TILE_SCHEDULE_H
+
+#include "definitions.h"
+#include "comms.h"
+
+void tile_size_to_cache(global_variables& globals, parallel_& parallel);
+void tile_spaces(global_variables& globals, parallel_& parallel);
+void tile_fence(global_variables& globals);
+
+#endif
+
@@ -21,19 +21,15 @@
 /**
  *  @brief C timer function.
  *  @author Oliver Perks
- *  @details C function to call from fortran.
+ *  @details Returns the time in seconds from a monotonic clock, so that
+ *  differences between two calls are not affected by adjustments to the
+ *  system time.
  */
 
-#include <sys/time.h>
-#include <sys/times.h>
-#include <sys/resource.h>
-#include <stdlib.h>
+#include <chrono>
 
 double timer()
 {
-   struct timeval t;
-   gettimeofday(&t, (struct timezone *) NULL);
-   return t.tv_sec + t.tv_usec * 1.0E-6;
+   return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
-
@@ -28,9 +28,10 @@
 
 #include "calc_dt.h"
 #include "ideal_gas.h"
-#include "timer.h"
+#include "profiler.h"
 #include "update_halo.h"
 #include "viscosity.h"
+#include "temporal_block.h"
 #include "report.h"
 
 extern std::ostream g_out;
@@ -43,59 +44,210 @@ void timestep(global_variables& globals, parallel_& parallel) {
   int fields[NUM_FIELDS];
 
   double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
+  if (globals.fused_timestep) {
+
+    // The pressure halo is recomputed from the exchanged density and energy,
+    // and the viscosity is calculated inside the timestep kernel
+    for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
+    fields[field_energy0] = 1;
+    fields[field_density0] = 1;
+    fields[field_xvel0] = 1;
+    fields[field_yvel0] = 1;
+    update_halo(globals, fields, 1);
+
+    kernel_time = profiler_start(globals, "ideal_gas");
+
+    for (int tile = 0; tile < globals.local_tiles; ++tile) {
+      ideal_gas_halo(globals, tile, 1);
+    }
+
+    profiler_stop(globals, globals.profiler.ideal_gas, kernel_time);
+
   }
+  else if (globals.temporal_blocking) {
 
-  if (globals.profiler_on) globals.profiler.ideal_gas += timer()-kernel_time;
+    // The one exchange of the step. The pressure halo is recomputed from the
+    // exchanged density and energy, and the viscosity as deep as the blocked
+    // phases read it
+    for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
+    fields[field_energy0] = 1;
+    fields[field_density0] = 1;
+    fields[field_xvel0] = 1;
+    fields[field_yvel0] = 1;
+    update_halo(globals, fields, g_block_depth);
 
-  for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
-  fields[field_pressure] = 1;
-  fields[field_energy0] = 1;
-  fields[field_density0] = 1;
-  fields[field_xvel0] = 1;
-  fields[field_yvel0] = 1;
-  update_halo(globals, fields, 1);
+    kernel_time = profiler_start(globals, "ideal_gas");
 
-  if (globals.profiler_on) kernel_time = timer();
-  viscosity(globals);
-  if (globals.profiler_on) globals.profiler.viscosity += timer()-kernel_time;
+    for (int tile = 0; tile < globals.local_tiles; ++tile) {
+      ideal_gas_halo(globals, tile, g_block_depth);
+    }
 
-  for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
-  fields[field_viscosity] = 1;
-  update_halo(globals, fields, 1);
+    profiler_stop(globals, globals.profiler.ideal_gas, kernel_time);
+
+    kernel_time = profiler_start(globals, "viscosity");
+    viscosity(globals, overlap_all, g_block_depth-1);
+    profiler_stop(globals, globals.profiler.viscosity, kernel_time);
+
+  }
+  else {
 
-  if (globals.profiler_on) kernel_time = timer();
+    kernel_time = profiler_start(globals, "ideal_gas");
 
-  int jldt, kldt;
+    for (int tile = 0; tile < globals.local_tiles; ++tile) {
+      ideal_gas(globals, tile, false, 0);
+    }
+
+    profiler_stop(globals, globals.profiler.ideal_gas, kernel_time);
+
+    for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
+    fields[field_pressure] = 1;
+    fields[field_energy0] = 1;
+    fields[field_density0] = 1;
+    fields[field_xvel0] = 1;
+    fields[field_yvel0] = 1;
+    if (globals.halo_depth > 2) {
+      // With a deep halo the pressure is exchanged two cells deep, enough to
+      // compute the viscosity of the first halo cell here rather than
+      // exchange it
+      update_halo(globals, fields, 2);
+
+      kernel_time = profiler_start(globals, "viscosity");
+      viscosity(globals, overlap_all, 1);
+      profiler_stop(globals, globals.profiler.viscosity, kernel_time);
+    }
+    else if (globals.overlap_halo) {
+      update_halo_start(globals, fields, 1);
+
+      kernel_time = profiler_start(globals, "viscosity");
+      viscosity(globals, overlap_interior, 0);
+      profiler_stop(globals, globals.profiler.viscosity, kernel_time);
+
+      update_halo_finish(globals, fields, 1);
+
+      kernel_time = profiler_start(globals, "viscosity");
+      viscosity(globals, overlap_boundary, 0);
+      profiler_stop(globals, globals.profiler.viscosity, kernel_time);
+    }
+    else {
+      update_halo(globals, fields, 1);
+
+      kernel_time = profiler_start(globals, "viscosity");
+      viscosity(globals, overlap_all, 0);
+      profiler_stop(globals, globals.profiler.viscosity, kernel_time);
+    }
+
+  }
+
+  kernel_time = profiler_start(globals, "timestep");
+
+  int jldt, kldt, dtl_control;
   double dtlp;
-  double x_pos, y_pos, xl_pos, yl_pos;
-  std::string dt_control, dtl_control;
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-    calc_dt(globals, tile, dtlp, dtl_control, xl_pos, yl_pos, jldt, kldt);
+  int dt_control = 1;
+  int dt_tile = 0;
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    calc_dt(globals, tile, dtlp, dtl_control, jldt, kldt);
 
     if (dtlp <= globals.dt) {
       globals.dt = dtlp;
       dt_control = dtl_control;
-      x_pos = xl_pos;
-      y_pos = yl_pos;
+      dt_tile = tile;
       globals.jdt = jldt;
       globals.kdt = kldt;
     }
   }
 
-  globals.dt = std::min(std::min(globals.dt, globals.dtold * globals.dtrise), globals.dtmax);
+  // Only the controlling cell of the task is read back, once the tiles are
+  // done
+  double cell[NUM_DT_CELL];
+  calc_dt_cell(globals, dt_tile, globals.jdt, globals.kdt, cell);
+
+  profiler_stop(globals, globals.profiler.timestep, kernel_time);
 
-  clover_min(globals.dt);
-  if (globals.profiler_on) globals.profiler.timestep += timer() - kernel_time;
+  // The reduction also finds the task holding the controlling cell. It is
+  // taken before the limits on the growth of the timestep, which are the same
+  // on every task, so that the cell is found even when they apply.
+  int dt_task = 0;
+
+  // The timestep reads no viscosity halo, so the viscosity exchange follows
+  // it and can hide a non-blocking reduction of the timestep. The reduction
+  // waits on the other tasks, so it is timed apart from the timestep kernels.
+  kernel_time = profiler_start(globals, "timestep_reduction");
+  if (globals.nonblocking_reductions) {
+    clover_min_start(globals.dt);
+  }
+  else {
+    clover_min(globals.dt, dt_task);
+  }
+  profiler_stop(globals, globals.profiler.timestep_reduction, kernel_time);
+
+  for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
+  fields[field_viscosity] = 1;
+  if (globals.temporal_blocking) {
+    update_halo_reflect(globals, fields, g_block_depth);
+  }
+  else if (globals.halo_depth > 2 && !globals.fused_timestep) {
+    update_halo_reflect(globals, fields, 1);
+  }
+  else if (globals.overlap_halo && globals.halo_depth == 2) {
+    // Nothing reads the viscosity halo before the acceleration, so the
+    // exchange is finished by PdV once the predictor has run. The predictor
+    // reads the halo when it is deep, so then the exchange is completed here.
+    update_halo_start(globals, fields, 1);
+  }
+  else {
+    update_halo(globals, fields, 1);
+  }
+
+  kernel_time = profiler_start(globals, "timestep_reduction");
+
+  if (globals.nonblocking_reductions) {
+    clover_min_finish(globals.dt, dt_task);
+  }
+
+  globals.dt = std::min(std::min(globals.dt, globals.dtold * globals.dtrise), globals.dtmax);
 
   if (globals.dt < globals.dtmin) small = 1;
 
+  // The task holding the controlling cell sends its control, its position
+  // in the whole mesh and its coordinates to the others
+  double location[5];
+  if (parallel.task == dt_task) {
+    location[0] = dt_control;
+    location[1] = globals.tiles[dt_tile].t_left+globals.jdt-1;
+    location[2] = globals.tiles[dt_tile].t_bottom+globals.kdt-1;
+    location[3] = cell[0];
+    location[4] = cell[1];
+
+    if (small == 1) {
+      std::cout
+        << "Timestep information:" << std::endl
+        << "j, k                 : " << location[1] << " " << location[2] << std::endl
+        << "x, y                 : " << cell[0] << " " << cell[1] << std::endl
+        << "timestep : " << globals.dt << std::endl
+        << "Cell velocities;" << std::endl
+        << cell[2] << " " << cell[3] << std::endl
+        << cell[4] << " " << cell[5] << std::endl
+        << cell[6] << " " << cell[7] << std::endl
+        << cell[8] << " " << cell[9] << std::endl
+        << "density, energy, pressure, soundspeed " << std::endl
+        << cell[10] << " " << cell[11] << " " << cell[12] << " " << cell[13] << std::endl;
+    }
+  }
+  clover_broadcast(location, 5, dt_task);
+
+  profiler_stop(globals, globals.profiler.timestep_reduction, kernel_time);
+
+  const std::string controls[4] = {"sound", "xvel", "yvel", "div"};
+  std::string dt_control_name = controls[(int)location[0]-1];
+  globals.jdt = (int)location[1];
+  globals.kdt = (int)location[2];
+  double x_pos = location[3];
+  double y_pos = location[4];
+
   if (parallel.boss) {
-    g_out << " Step " << globals.step << " time " << globals.time << " control " << dt_control << " timestep  " << globals.dt << " " << globals.jdt << "," << globals.kdt << " x " << x_pos << " y " << y_pos << std::endl;
-    std::cout << " Step " << globals.step << " time " << globals.time << " control " << dt_control << " timestep  " << globals.dt << " " << globals.jdt << "," << globals.kdt << " x " << x_pos << " y " << y_pos << std::endl;
+    g_out << " Step " << globals.step << " time " << globals.time << " control " << dt_control_name << " timestep  " << globals.dt << " " << globals.jdt << "," << globals.kdt << " x " << x_pos << " y " << y_pos << std::endl;
+    std::cout << " Step " << globals.step << " time " << globals.time << " control " << dt_control_name << " timestep  " << globals.dt << " " << globals.jdt << "," << globals.kdt << " x " << x_pos << " y " << y_pos << std::endl;
   }
 
   if (small == 1) {
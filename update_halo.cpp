@@ -21,7 +21,8 @@
 #include "comms.h"
 #include "update_halo.h"
 #include "update_tile_halo.h"
-#include "timer.h"
+#include "profiler.h"
+#include "tile_schedule.h"
 
 
 //   @brief Fortran kernel to update the external halo cells in a chunk.
@@ -31,43 +32,44 @@
 //   of data governs how this is carried out. External boundaries are always
 //   reflective.
 void update_halo_kernel(
+  const exec_space& space,
   int x_min, int x_max, int y_min, int y_max,
   int chunk_neighbours[4], int tile_neighbours[4],
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity,
-  Kokkos::View<double**>& soundspeed,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel1,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& vol_flux_y,
-  Kokkos::View<double**>& mass_flux_x,
-  Kokkos::View<double**>& mass_flux_y,
+  field_view& density0,
+  field_view& energy0,
+  field_view& pressure,
+  work_view& viscosity,
+  work_view& soundspeed,
+  field_view& density1,
+  field_view& energy1,
+  field_view& xvel0,
+  field_view& yvel0,
+  field_view& xvel1,
+  field_view& yvel1,
+  field_view& vol_flux_x,
+  field_view& vol_flux_y,
+  field_view& mass_flux_x,
+  field_view& mass_flux_y,
   int fields[NUM_FIELDS],
   int depth) {
 
 
     //  Update values in external halo cells based on depth and fields requested
     //  Even though half of these loops look the wrong way around, it should be noted
-    //  that depth is either 1 or 2 so that it is more efficient to always thread
-    //  loop along the mesh edge.
+    //  that depth is at most halo_depth, a few cells against the length of a tile
+    //  edge, so that it is more efficient to always thread loop along the mesh edge.
     if (fields[field_density0] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            density0(j,1-k) = density0(j,2+k);
+            density0(j,y_min-k) = density0(j,y_min+1+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             density0(j,y_max+2+k)=density0(j,y_max+1-k);
           }
@@ -75,15 +77,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            density0(1-j,k)=density0(2+j,k);
+            density0(x_min-j,k)=density0(x_min+1+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             density0(x_max+2+j,k)=density0(x_max+1-j,k);
           }
@@ -95,15 +97,15 @@ void update_halo_kernel(
     if (fields[field_density1] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            density1(j,1-k)=density1(j,2+k);
+            density1(j,y_min-k)=density1(j,y_min+1+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             density1(j,y_max+2+k)=density1(j,y_max+1-k);
           }
@@ -111,15 +113,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            density1(1-j,k)=density1(2+j,k);
+            density1(x_min-j,k)=density1(x_min+1+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             density1(x_max+2+j,k)=density1(x_max+1-j,k);
           }
@@ -130,15 +132,15 @@ void update_halo_kernel(
     if (fields[field_energy0] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         //  DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            energy0(j,1-k) = energy0(j,2+k);
+            energy0(j,y_min-k) = energy0(j,y_min+1+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             energy0(j,y_max+2+k)=energy0(j,y_max+1-k);
           }
@@ -146,15 +148,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            energy0(1-j,k)=energy0(2+j,k);
+            energy0(x_min-j,k)=energy0(x_min+1+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             energy0(x_max+2+j,k)=energy0(x_max+1-j,k);
           }
@@ -166,15 +168,15 @@ void update_halo_kernel(
     if (fields[field_energy1] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            energy1(j,1-k)=energy1(j,2+k);
+            energy1(j,y_min-k)=energy1(j,y_min+1+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             energy1(j,y_max+2+k)=energy1(j,y_max+1-k);
           }
@@ -182,15 +184,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            energy1(1-j,k)=energy1(2+j,k);
+            energy1(x_min-j,k)=energy1(x_min+1+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             energy1(x_max+2+j,k)=energy1(x_max+1-j,k);
           }
@@ -201,15 +203,15 @@ void update_halo_kernel(
     if (fields[field_pressure] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            pressure(j,1-k)=pressure(j,2+k);
+            pressure(j,y_min-k)=pressure(j,y_min+1+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             pressure(j,y_max+2+k)=pressure(j,y_max+1-k);
           }
@@ -217,15 +219,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            pressure(1-j,k)=pressure(2+j,k);
+            pressure(x_min-j,k)=pressure(x_min+1+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             pressure(x_max+2+j,k)=pressure(x_max+1-j,k);
           }
@@ -236,15 +238,15 @@ void update_halo_kernel(
     if (fields[field_viscosity] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            viscosity(j,1-k)=viscosity(j,2+k);
+            viscosity(j,y_min-k)=viscosity(j,y_min+1+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             viscosity(j,y_max+2+k)=viscosity(j,y_max+1-k);
           }
@@ -252,15 +254,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            viscosity(1-j,k)=viscosity(2+j,k);
+            viscosity(x_min-j,k)=viscosity(x_min+1+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             viscosity(x_max+2+j,k)=viscosity(x_max+1-j,k);
           }
@@ -271,15 +273,15 @@ void update_halo_kernel(
     if (fields[field_soundspeed] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            soundspeed(j,1-k)=soundspeed(j,2+k);
+            soundspeed(j,y_min-k)=soundspeed(j,y_min+1+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1, x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             soundspeed(j,y_max+2+k)=soundspeed(j,y_max+1-k);
           }
@@ -287,15 +289,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         //  DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            soundspeed(1-j,k)=soundspeed(2+j,k);
+            soundspeed(x_min-j,k)=soundspeed(x_min+1+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         //  DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1, y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             soundspeed(x_max+2+j,k)=soundspeed(x_max+1-j,k);
           }
@@ -310,15 +312,15 @@ void update_halo_kernel(
     if (fields[field_xvel0] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            xvel0(j,1-k)=xvel0(j,1+2+k);
+            xvel0(j,y_min-k)=xvel0(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             xvel0(j,y_max+1+2+k)=xvel0(j,y_max+1-k);
           }
@@ -326,15 +328,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            xvel0(1-j,k)=-xvel0(1+2+j,k);
+            xvel0(x_min-j,k)=-xvel0(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             xvel0(x_max+2+1+j,k)=-xvel0(x_max+1-j,k);
           }
@@ -345,15 +347,15 @@ void update_halo_kernel(
     if (fields[field_xvel1] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            xvel1(j,1-k)=xvel1(j,1+2+k);
+            xvel1(j,y_min-k)=xvel1(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             xvel1(j,y_max+1+2+k)=xvel1(j,y_max+1-k);
           }
@@ -361,15 +363,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            xvel1(1-j,k)=-xvel1(1+2+j,k);
+            xvel1(x_min-j,k)=-xvel1(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             xvel1(x_max+2+1+j,k)=-xvel1(x_max+1-j,k);
           }
@@ -380,15 +382,15 @@ void update_halo_kernel(
     if (fields[field_yvel0] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            yvel0(j,1-k)=-yvel0(j,1+2+k);
+            yvel0(j,y_min-k)=-yvel0(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             yvel0(j,y_max+1+2+k)=-yvel0(j,y_max+1-k);
           }
@@ -396,15 +398,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            yvel0(1-j,k)=yvel0(1+2+j,k);
+            yvel0(x_min-j,k)=yvel0(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             yvel0(x_max+2+1+j,k)=yvel0(x_max+1-j,k);
           }
@@ -415,15 +417,15 @@ void update_halo_kernel(
     if (fields[field_yvel1] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            yvel1(j,1-k)=-yvel1(j,1+2+k);
+            yvel1(j,y_min-k)=-yvel1(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             yvel1(j,y_max+1+2+k)=-yvel1(j,y_max+1-k);
           }
@@ -431,15 +433,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            yvel1(1-j,k)=yvel1(1+2+j,k);
+            yvel1(x_min-j,k)=yvel1(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             yvel1(x_max+2+1+j,k)=yvel1(x_max+1-j,k);
           }
@@ -453,15 +455,15 @@ void update_halo_kernel(
     if (fields[field_vol_flux_x] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            vol_flux_x(j,1-k)=vol_flux_x(j,1+2+k);
+            vol_flux_x(j,y_min-k)=vol_flux_x(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             vol_flux_x(j,y_max+2+k)=vol_flux_x(j,y_max-k);
           }
@@ -469,15 +471,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            vol_flux_x(1-j,k)=-vol_flux_x(1+2+j,k);
+            vol_flux_x(x_min-j,k)=-vol_flux_x(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             vol_flux_x(x_max+j+1+2,k)=-vol_flux_x(x_max+1-j,k);
           }
@@ -489,15 +491,15 @@ void update_halo_kernel(
     if (fields[field_mass_flux_x] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            mass_flux_x(j,1-k)=mass_flux_x(j,1+2+k);
+            mass_flux_x(j,y_min-k)=mass_flux_x(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+1+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             mass_flux_x(j,y_max+2+k)=mass_flux_x(j,y_max-k);
           }
@@ -505,15 +507,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            mass_flux_x(1-j,k)=-mass_flux_x(1+2+j,k);
+            mass_flux_x(x_min-j,k)=-mass_flux_x(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             mass_flux_x(x_max+j+1+2,k)=-mass_flux_x(x_max+1-j,k);
           }
@@ -525,15 +527,15 @@ void update_halo_kernel(
     if (fields[field_vol_flux_y] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            vol_flux_y(j,1-k)=-vol_flux_y(j,1+2+k);
+            vol_flux_y(j,y_min-k)=-vol_flux_y(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             vol_flux_y(j,y_max+k+1+2)=-vol_flux_y(j,y_max+1-k);
           }
@@ -541,15 +543,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            vol_flux_y(1-j,k)=vol_flux_y(1+2+j,k);
+            vol_flux_y(x_min-j,k)=vol_flux_y(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             vol_flux_y(x_max+2+j,k)=vol_flux_y(x_max-j,k);
           }
@@ -560,15 +562,15 @@ void update_halo_kernel(
     if (fields[field_mass_flux_y] == 1) {
       if ((chunk_neighbours[chunk_bottom] == external_face) && (tile_neighbours[tile_bottom] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
-            mass_flux_y(j,1-k)=-mass_flux_y(j,1+2+k);
+            mass_flux_y(j,y_min-k)=-mass_flux_y(j,y_min+2+k);
           }
         });
       }
       if ((chunk_neighbours[chunk_top] == external_face) && (tile_neighbours[tile_top] == external_tile)) {
         // DO j=x_min-depth,x_max+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, x_min-depth+1,x_max+depth+2), KOKKOS_LAMBDA (const int j) {
           for (int k = 0; k < depth; ++k) {
             mass_flux_y(j,y_max+k+1+2)=-mass_flux_y(j,y_max+1-k);
           }
@@ -576,15 +578,15 @@ void update_halo_kernel(
       }
       if ((chunk_neighbours[chunk_left] == external_face) && (tile_neighbours[tile_left] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
-            mass_flux_y(1-j,k)=mass_flux_y(1+2+j,k);
+            mass_flux_y(x_min-j,k)=mass_flux_y(x_min+2+j,k);
           }
         });
       }
       if ((chunk_neighbours[chunk_right] == external_face) && (tile_neighbours[tile_right] == external_tile)) {
         // DO k=y_min-depth,y_max+1+depth
-        Kokkos::parallel_for(Kokkos::RangePolicy<>(y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
+        Kokkos::parallel_for(Kokkos::RangePolicy<>(space, y_min-depth+1,y_max+1+depth+2), KOKKOS_LAMBDA (const int k) {
           for (int j = 0; j < depth; ++j) {
             mass_flux_y(x_max+2+j,k)=mass_flux_y(x_max-j,k);
           }
@@ -604,56 +606,118 @@ void update_halo_kernel(
 //  the fields specified.
 void update_halo(global_variables& globals, int fields[NUM_FIELDS], const int depth) {
 
-  double kernel_time;
-  if (globals.profiler_on) kernel_time = timer();
+  update_halo_start(globals, fields, depth);
+  update_halo_finish(globals, fields, depth);
+}
+
+//  @brief Starts a split phase halo update.
+//  @details Exchanges the tile halos and posts the MPI messages. Until
+//  update_halo_finish is called with the same fields and depth the chunk halo
+//  of those fields must not be read, and the fields must not be written.
+void update_halo_start(global_variables& globals, int fields[NUM_FIELDS], const int depth) {
+
+  // The exchanges read the tiles from the default instance
+  tile_fence(globals);
+
+  double kernel_time = profiler_start(globals, "tile_halo_exchange");
   update_tile_halo(globals, fields, depth);
-  if (globals.profiler_on) {
-    globals.profiler.tile_halo_exchange += timer() - kernel_time;
-    kernel_time = timer();
-  }
+  profiler_stop(globals, globals.profiler.tile_halo_exchange, kernel_time);
+
+  kernel_time = profiler_start(globals, "mpi_halo_exchange");
+  clover_exchange_start(globals, fields, depth);
+  profiler_stop(globals, globals.profiler.mpi_halo_exchange, kernel_time);
+}
 
-  clover_exchange(globals, fields, depth);
+//  @brief Completes a split phase halo update.
+//  @details Waits for the MPI messages and then applies the reflective
+//  boundary conditions on the external faces.
+void update_halo_finish(global_variables& globals, int fields[NUM_FIELDS], const int depth) {
 
-  if (globals.profiler_on) {
-    globals.profiler.mpi_halo_exchange += timer() - kernel_time;
-    kernel_time = timer();
-  }
+  double kernel_time = profiler_start(globals, "mpi_halo_exchange");
+  clover_exchange_finish(globals);
+  profiler_stop(globals, globals.profiler.mpi_halo_exchange, kernel_time);
 
-  if ((globals.chunk.chunk_neighbours[chunk_left] == external_face) ||
-      (globals.chunk.chunk_neighbours[chunk_right] == external_face) ||
-      (globals.chunk.chunk_neighbours[chunk_bottom] == external_face) ||
-      (globals.chunk.chunk_neighbours[chunk_top] == external_face) ) {
-
-    for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-
-     update_halo_kernel(
-       globals.chunk.tiles[tile].t_xmin,
-       globals.chunk.tiles[tile].t_xmax,
-       globals.chunk.tiles[tile].t_ymin,
-       globals.chunk.tiles[tile].t_ymax,
-       globals.chunk.chunk_neighbours,
-       globals.chunk.tiles[tile].tile_neighbours,
-       globals.chunk.tiles[tile].field.density0,
-       globals.chunk.tiles[tile].field.energy0,
-       globals.chunk.tiles[tile].field.pressure,
-       globals.chunk.tiles[tile].field.viscosity,
-       globals.chunk.tiles[tile].field.soundspeed,
-       globals.chunk.tiles[tile].field.density1,
-       globals.chunk.tiles[tile].field.energy1,
-       globals.chunk.tiles[tile].field.xvel0,
-       globals.chunk.tiles[tile].field.yvel0,
-       globals.chunk.tiles[tile].field.xvel1,
-       globals.chunk.tiles[tile].field.yvel1,
-       globals.chunk.tiles[tile].field.vol_flux_x,
-       globals.chunk.tiles[tile].field.vol_flux_y,
-       globals.chunk.tiles[tile].field.mass_flux_x,
-       globals.chunk.tiles[tile].field.mass_flux_y,
-       fields,
-       depth);
-    }
+  update_halo_reflect(globals, fields, depth);
+}
+
+//  @brief Applies the reflective boundary conditions only.
+//  @details Updates the halo cells on the external faces from the chunk
+//  without any exchange, for fields whose halo on the internal faces has
+//  been computed redundantly.
+void update_halo_reflect(global_variables& globals, int fields[NUM_FIELDS], const int depth) {
+
+  tile_fence(globals);
+
+  double kernel_time = profiler_start(globals, "self_halo_exchange");
+
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    update_halo_reflect_tile(globals, tile, fields, depth);
   }
 
-  if (globals.profiler_on)
-    globals.profiler.self_halo_exchange += timer() - kernel_time;
+  profiler_stop(globals, globals.profiler.self_halo_exchange, kernel_time);
+
+  // The tiles read the updated halos from their own instances
+  tile_fence(globals);
+}
+
+//  @brief Applies the reflective boundary conditions to one tile.
+//  @details Updates the halo cells of the tile that lie on the external faces
+//  of its chunk, if it has any. The kernels run on the tile's instance.
+void update_halo_reflect_tile(global_variables& globals, int tile, int fields[NUM_FIELDS], const int depth) {
+
+  chunk_type& chunk = globals.chunks[globals.tiles[tile].chunk];
+
+  if ((chunk.chunk_neighbours[chunk_left] == external_face) ||
+      (chunk.chunk_neighbours[chunk_right] == external_face) ||
+      (chunk.chunk_neighbours[chunk_bottom] == external_face) ||
+      (chunk.chunk_neighbours[chunk_top] == external_face) ) {
+
+    update_halo_kernel(
+      globals.tiles[tile].space,
+      globals.tiles[tile].t_xmin,
+      globals.tiles[tile].t_xmax,
+      globals.tiles[tile].t_ymin,
+      globals.tiles[tile].t_ymax,
+      chunk.chunk_neighbours,
+      globals.tiles[tile].tile_neighbours,
+      globals.tiles[tile].field.density0,
+      globals.tiles[tile].field.energy0,
+      globals.tiles[tile].field.pressure,
+      globals.tiles[tile].field.viscosity,
+      globals.tiles[tile].field.soundspeed,
+      globals.tiles[tile].field.density1,
+      globals.tiles[tile].field.energy1,
+      globals.tiles[tile].field.xvel0,
+      globals.tiles[tile].field.yvel0,
+      globals.tiles[tile].field.xvel1,
+      globals.tiles[tile].field.yvel1,
+      globals.tiles[tile].field.vol_flux_x,
+      globals.tiles[tile].field.vol_flux_y,
+      globals.tiles[tile].field.mass_flux_x,
+      globals.tiles[tile].field.mass_flux_y,
+      fields,
+      depth);
+  }
 }
 
+
+//  @brief Bounds of a tile grown into its halo.
+//  @details Moves each side of the tile ring cells out into the halo, except
+//  on external faces, which are only ever set by the reflective update. A
+//  kernel run over the grown tile repeats the work of the neighbouring tile
+//  or chunk for those cells, so their halo needs no exchange afterwards.
+void redundant_bounds(global_variables& globals, int tile, int ring, int& x_min, int& x_max, int& y_min, int& y_max) {
+
+  tile_type& t = globals.tiles[tile];
+  chunk_type& chunk = globals.chunks[t.chunk];
+
+  x_min = t.t_xmin;
+  x_max = t.t_xmax;
+  y_min = t.t_ymin;
+  y_max = t.t_ymax;
+
+  if ((chunk.chunk_neighbours[chunk_left] != external_face) || (t.tile_neighbours[tile_left] != external_tile)) x_min -= ring;
+  if ((chunk.chunk_neighbours[chunk_right] != external_face) || (t.tile_neighbours[tile_right] != external_tile)) x_max += ring;
+  if ((chunk.chunk_neighbours[chunk_bottom] != external_face) || (t.tile_neighbours[tile_bottom] != external_tile)) y_min -= ring;
+  if ((chunk.chunk_neighbours[chunk_top] != external_face) || (t.tile_neighbours[tile_top] != external_tile)) y_max += ring;
+}
@@ -24,6 +24,12 @@
 #include "definitions.h"
 
 void update_halo(global_variables& globals, int fields[NUM_FIELDS], const int depth);
+void update_halo_start(global_variables& globals, int fields[NUM_FIELDS], const int depth);
+void update_halo_finish(global_variables& globals, int fields[NUM_FIELDS], const int depth);
+void update_halo_reflect(global_variables& globals, int fields[NUM_FIELDS], const int depth);
+void update_halo_reflect_tile(global_variables& globals, int tile, int fields[NUM_FIELDS], const int depth);
+
+void redundant_bounds(global_variables& globals, int tile, int ring, int& x_min, int& x_max, int& y_min, int& y_max);
 
 #endif
 
@@ -31,37 +31,37 @@
 
 void update_tile_halo_l_kernel(
   int x_min, int x_max, int y_min,int y_max,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity,
-  Kokkos::View<double**>& soundspeed,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel1,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& vol_flux_y,
-  Kokkos::View<double**>& mass_flux_x,
-  Kokkos::View<double**>& mass_flux_y,
+  field_view& density0,
+  field_view& energy0,
+  field_view& pressure,
+  work_view& viscosity,
+  work_view& soundspeed,
+  field_view& density1,
+  field_view& energy1,
+  field_view& xvel0,
+  field_view& yvel0,
+  field_view& xvel1,
+  field_view& yvel1,
+  field_view& vol_flux_x,
+  field_view& vol_flux_y,
+  field_view& mass_flux_x,
+  field_view& mass_flux_y,
   int left_xmin, int left_xmax, int left_ymin, int left_ymax,
-  Kokkos::View<double**>& left_density0,
-  Kokkos::View<double**>& left_energy0,
-  Kokkos::View<double**>& left_pressure,
-  Kokkos::View<double**>& left_viscosity,
-  Kokkos::View<double**>& left_soundspeed,
-  Kokkos::View<double**>& left_density1,
-  Kokkos::View<double**>& left_energy1,
-  Kokkos::View<double**>& left_xvel0,
-  Kokkos::View<double**>& left_yvel0,
-  Kokkos::View<double**>& left_xvel1,
-  Kokkos::View<double**>& left_yvel1,
-  Kokkos::View<double**>& left_vol_flux_x,
-  Kokkos::View<double**>& left_vol_flux_y,
-  Kokkos::View<double**>& left_mass_flux_x,
-  Kokkos::View<double**>& left_mass_flux_y,
+  field_view& left_density0,
+  field_view& left_energy0,
+  field_view& left_pressure,
+  work_view& left_viscosity,
+  work_view& left_soundspeed,
+  field_view& left_density1,
+  field_view& left_energy1,
+  field_view& left_xvel0,
+  field_view& left_yvel0,
+  field_view& left_xvel1,
+  field_view& left_yvel1,
+  field_view& left_vol_flux_x,
+  field_view& left_vol_flux_y,
+  field_view& left_mass_flux_x,
+  field_view& left_mass_flux_y,
   int fields[NUM_FIELDS],
   int depth) {
 
@@ -252,37 +252,37 @@ void update_tile_halo_l_kernel(
 
 void update_tile_halo_r_kernel(
   int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity,
-  Kokkos::View<double**>& soundspeed,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel1,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& vol_flux_y,
-  Kokkos::View<double**>& mass_flux_x,
-  Kokkos::View<double**>& mass_flux_y,
+  field_view& density0,
+  field_view& energy0,
+  field_view& pressure,
+  work_view& viscosity,
+  work_view& soundspeed,
+  field_view& density1,
+  field_view& energy1,
+  field_view& xvel0,
+  field_view& yvel0,
+  field_view& xvel1,
+  field_view& yvel1,
+  field_view& vol_flux_x,
+  field_view& vol_flux_y,
+  field_view& mass_flux_x,
+  field_view& mass_flux_y,
   int right_xmin, int right_xmax, int right_ymin, int right_ymax,
-  Kokkos::View<double**>& right_density0,
-  Kokkos::View<double**>& right_energy0,
-  Kokkos::View<double**>& right_pressure,
-  Kokkos::View<double**>& right_viscosity,
-  Kokkos::View<double**>& right_soundspeed,
-  Kokkos::View<double**>& right_density1,
-  Kokkos::View<double**>& right_energy1,
-  Kokkos::View<double**>& right_xvel0,
-  Kokkos::View<double**>& right_yvel0,
-  Kokkos::View<double**>& right_xvel1,
-  Kokkos::View<double**>& right_yvel1,
-  Kokkos::View<double**>& right_vol_flux_x,
-  Kokkos::View<double**>& right_vol_flux_y,
-  Kokkos::View<double**>& right_mass_flux_x,
-  Kokkos::View<double**>& right_mass_flux_y,
+  field_view& right_density0,
+  field_view& right_energy0,
+  field_view& right_pressure,
+  work_view& right_viscosity,
+  work_view& right_soundspeed,
+  field_view& right_density1,
+  field_view& right_energy1,
+  field_view& right_xvel0,
+  field_view& right_yvel0,
+  field_view& right_xvel1,
+  field_view& right_yvel1,
+  field_view& right_vol_flux_x,
+  field_view& right_vol_flux_y,
+  field_view& right_mass_flux_x,
+  field_view& right_mass_flux_y,
   int fields[NUM_FIELDS],
   int depth) {
 
@@ -476,37 +476,37 @@ void update_tile_halo_r_kernel(
 
 void update_tile_halo_t_kernel(
   int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity,
-  Kokkos::View<double**>& soundspeed,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel1,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& vol_flux_y,
-  Kokkos::View<double**>& mass_flux_x,
-  Kokkos::View<double**>& mass_flux_y,
+  field_view& density0,
+  field_view& energy0,
+  field_view& pressure,
+  work_view& viscosity,
+  work_view& soundspeed,
+  field_view& density1,
+  field_view& energy1,
+  field_view& xvel0,
+  field_view& yvel0,
+  field_view& xvel1,
+  field_view& yvel1,
+  field_view& vol_flux_x,
+  field_view& vol_flux_y,
+  field_view& mass_flux_x,
+  field_view& mass_flux_y,
   int top_xmin, int top_xmax, int top_ymin, int top_ymax,
-  Kokkos::View<double**>& top_density0,
-  Kokkos::View<double**>& top_energy0,
-  Kokkos::View<double**>& top_pressure,
-  Kokkos::View<double**>& top_viscosity,
-  Kokkos::View<double**>& top_soundspeed,
-  Kokkos::View<double**>& top_density1,
-  Kokkos::View<double**>& top_energy1,
-  Kokkos::View<double**>& top_xvel0,
-  Kokkos::View<double**>& top_yvel0,
-  Kokkos::View<double**>& top_xvel1,
-  Kokkos::View<double**>& top_yvel1,
-  Kokkos::View<double**>& top_vol_flux_x,
-  Kokkos::View<double**>& top_vol_flux_y,
-  Kokkos::View<double**>& top_mass_flux_x,
-  Kokkos::View<double**>& top_mass_flux_y,
+  field_view& top_density0,
+  field_view& top_energy0,
+  field_view& top_pressure,
+  work_view& top_viscosity,
+  work_view& top_soundspeed,
+  field_view& top_density1,
+  field_view& top_energy1,
+  field_view& top_xvel0,
+  field_view& top_yvel0,
+  field_view& top_xvel1,
+  field_view& top_yvel1,
+  field_view& top_vol_flux_x,
+  field_view& top_vol_flux_y,
+  field_view& top_mass_flux_x,
+  field_view& top_mass_flux_y,
   int fields[NUM_FIELDS],
   int depth) {
 
@@ -696,37 +696,37 @@ void update_tile_halo_t_kernel(
 
 void update_tile_halo_b_kernel(
   int x_min, int x_max, int y_min, int y_max,
-  Kokkos::View<double**>& density0,
-  Kokkos::View<double**>& energy0,
-  Kokkos::View<double**>& pressure,
-  Kokkos::View<double**>& viscosity,
-  Kokkos::View<double**>& soundspeed,
-  Kokkos::View<double**>& density1,
-  Kokkos::View<double**>& energy1,
-  Kokkos::View<double**>& xvel0,
-  Kokkos::View<double**>& yvel0,
-  Kokkos::View<double**>& xvel1,
-  Kokkos::View<double**>& yvel1,
-  Kokkos::View<double**>& vol_flux_x,
-  Kokkos::View<double**>& vol_flux_y,
-  Kokkos::View<double**>& mass_flux_x,
-  Kokkos::View<double**>& mass_flux_y,
+  field_view& density0,
+  field_view& energy0,
+  field_view& pressure,
+  work_view& viscosity,
+  work_view& soundspeed,
+  field_view& density1,
+  field_view& energy1,
+  field_view& xvel0,
+  field_view& yvel0,
+  field_view& xvel1,
+  field_view& yvel1,
+  field_view& vol_flux_x,
+  field_view& vol_flux_y,
+  field_view& mass_flux_x,
+  field_view& mass_flux_y,
   int bottom_xmin, int bottom_xmax, int bottom_ymin, int bottom_ymax,
-  Kokkos::View<double**>& bottom_density0,
-  Kokkos::View<double**>& bottom_energy0,
-  Kokkos::View<double**>& bottom_pressure,
-  Kokkos::View<double**>& bottom_viscosity,
-  Kokkos::View<double**>& bottom_soundspeed,
-  Kokkos::View<double**>& bottom_density1,
-  Kokkos::View<double**>& bottom_energy1,
-  Kokkos::View<double**>& bottom_xvel0,
-  Kokkos::View<double**>& bottom_yvel0,
-  Kokkos::View<double**>& bottom_xvel1,
-  Kokkos::View<double**>& bottom_yvel1,
-  Kokkos::View<double**>& bottom_vol_flux_x,
-  Kokkos::View<double**>& bottom_vol_flux_y,
-  Kokkos::View<double**>& bottom_mass_flux_x,
-  Kokkos::View<double**>& bottom_mass_flux_y,
+  field_view& bottom_density0,
+  field_view& bottom_energy0,
+  field_view& bottom_pressure,
+  work_view& bottom_viscosity,
+  work_view& bottom_soundspeed,
+  field_view& bottom_density1,
+  field_view& bottom_energy1,
+  field_view& bottom_xvel0,
+  field_view& bottom_yvel0,
+  field_view& bottom_xvel1,
+  field_view& bottom_yvel1,
+  field_view& bottom_vol_flux_x,
+  field_view& bottom_vol_flux_y,
+  field_view& bottom_mass_flux_x,
+  field_view& bottom_mass_flux_y,
   int fields[NUM_FIELDS],
   int depth) {
 
@@ -23,7 +23,58 @@
 
 #include "definitions.h"
 
-void viscosity(global_variables& globals);
+//  @brief Artificial viscosity of a single cell
+//  @details Shared by the viscosity kernel and the fused timestep kernel so
+//  that both give identical results. Templated on the view types so the
+//  layout benchmark can run it on either layout.
+template <class view_1d, class view_2d>
+KOKKOS_INLINE_FUNCTION
+double viscosity_cell(const int j, const int k,
+  const view_1d& celldx,
+  const view_1d& celldy,
+  const view_2d& density0,
+  const view_2d& pressure,
+  const view_2d& xvel0,
+  const view_2d& yvel0) {
+
+  double ugrad = (xvel0(j+1,k  )+xvel0(j+1,k+1))-(xvel0(j  ,k  )+xvel0(j  ,k+1));
+
+  double vgrad = (yvel0(j  ,k+1)+yvel0(j+1,k+1))-(yvel0(j  ,k  )+yvel0(j+1,k  ));
+
+  double div = (celldx(j)*(ugrad)+  celldy(k)*(vgrad));
+
+  double strain2 = 0.5*(xvel0(j,  k+1) + xvel0(j+1,k+1)-xvel0(j  ,k  )-xvel0(j+1,k  ))/celldy(k) 
+    + 0.5*(yvel0(j+1,k  ) + yvel0(j+1,k+1)-yvel0(j  ,k  )-yvel0(j  ,k+1))/celldx(j);
+
+  double pgradx=(pressure(j+1,k)-pressure(j-1,k))/(celldx(j)+celldx(j+1));
+  double pgrady=(pressure(j,k+1)-pressure(j,k-1))/(celldy(k)+celldy(k+1));
+
+  double pgradx2 = pgradx*pgradx;
+  double pgrady2 = pgrady*pgrady;
+
+  double limiter = ((0.5*(ugrad)/celldx(j))*pgradx2+(0.5*(vgrad)/celldy(k))*pgrady2+strain2*pgradx*pgrady)
+    /MAX(pgradx2+pgrady2,1.0e-16);
+
+  if ((limiter > 0.0) || (div >= 0.0)) {
+    return 0.0;
+  }
+
+  double dirx=1.0;
+  if (pgradx < 0.0) dirx=-1.0;
+  pgradx = dirx*MAX(1.0e-16,fabs(pgradx));
+  double diry=1.0;
+  if (pgradx < 0.0) diry=-1.0;
+  pgrady = diry*MAX(1.0e-16,fabs(pgrady));
+  double pgrad = sqrt(pgradx*pgradx+pgrady*pgrady);
+  double xgrad = fabs(celldx(j)*pgrad/pgradx);
+  double ygrad = fabs(celldy(k)*pgrad/pgrady);
+  double grad  = MIN(xgrad,ygrad);
+  double grad2 = grad*grad;
+
+  return 2.0*density0(j,k)*grad2*limiter*limiter;
+}
+
+void viscosity(global_variables& globals, overlap_part part, int ring);
 
 #endif
 
@@ -19,7 +19,7 @@
 
 
 #include "visit.h"
-#include "timer.h"
+#include "profiler.h"
 #include "ideal_gas.h"
 #include "update_halo.h"
 #include "viscosity.h"
@@ -53,12 +53,11 @@ void visit(global_variables& globals, parallel_& parallel) {
     }
   }
 
-  double kernel_time;
-  if (globals.profiler_on) kernel_time=timer();
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
+  double kernel_time = profiler_start(globals, "ideal_gas");
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    ideal_gas(globals, tile, false, 0);
   }
-  if (globals.profiler_on) globals.profiler.ideal_gas += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.ideal_gas, kernel_time);
 
   int fields[NUM_FIELDS];
   for (int i = 0; i < NUM_FIELDS; ++i) fields[i] = 0;
@@ -67,16 +66,16 @@ void visit(global_variables& globals, parallel_& parallel) {
   fields[field_yvel0] = 1;
   update_halo(globals, fields, 1);
 
-  if (globals.profiler_on) kernel_time=timer();
-  viscosity(globals);
-  if (globals.profiler_on) globals.profiler.viscosity += timer()-kernel_time;
+  kernel_time = profiler_start(globals, "viscosity");
+  viscosity(globals, overlap_all, 0);
+  profiler_stop(globals, globals.profiler.viscosity, kernel_time);
 
   if (parallel.boss)  {
 
     std::string filename = "clover.visit";
     std::ofstream u;
     u.open(filename, std::ios::app);
-    for (int c = 0; c < parallel.max_task; ++c) {
+    for (int c = 0; c < globals.number_of_chunks; ++c) {
       std::stringstream namestream;
       namestream << "." << std::setfill('0') << std::setw(5) << c;
       for (int tile = 1; tile <= globals.tiles_per_chunk; ++tile) {
@@ -89,19 +88,20 @@ void visit(global_variables& globals, parallel_& parallel) {
     u.close();
   }
 
-  if (globals.profiler_on) kernel_time=timer();
+  kernel_time = profiler_start(globals, "visit");
 
-  for (int tile = 0; tile < globals.tiles_per_chunk; ++tile) {
-    if (globals.chunk.task == parallel.task) {
-      int nxc = globals.chunk.tiles[tile].t_xmax-globals.chunk.tiles[tile].t_xmin+1;
-      int nyc = globals.chunk.tiles[tile].t_ymax-globals.chunk.tiles[tile].t_ymin+1;
+  for (int tile = 0; tile < globals.local_tiles; ++tile) {
+    chunk_type& chunk = globals.chunks[globals.tiles[tile].chunk];
+    if (chunk.task == parallel.task) {
+      int nxc = globals.tiles[tile].t_xmax-globals.tiles[tile].t_xmin+1;
+      int nyc = globals.tiles[tile].t_ymax-globals.tiles[tile].t_ymin+1;
       int nxv=nxc+1;
       int nyv=nyc+1;
 
       std::stringstream namestream;
       namestream << name;
-      namestream << "." << std::setfill('0') << std::setw(5) << parallel.task;
-      namestream << "." << std::setfill('0') << std::setw(5) << tile+1;
+      namestream << "." << std::setfill('0') << std::setw(5) << chunk.number-1;
+      namestream << "." << std::setfill('0') << std::setw(5) << tile-chunk.first_tile+1;
       namestream << "." << std::setfill('0') << std::setw(5) << globals.step;
       namestream << ".vtk";
       std::ofstream u;
@@ -113,19 +113,19 @@ void visit(global_variables& globals, parallel_& parallel) {
       u << "DIMENSIONS " << nxv << " " << nyv << " 1" << std::endl;
       u << "X_COORDINATES " << nxv << " double" << std::endl;
 
-      typename Kokkos::View<double*>::HostMirror hm_vertexx = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.vertexx);
-      Kokkos::deep_copy(hm_vertexx, globals.chunk.tiles[tile].field.vertexx);
+      typename Kokkos::View<double*>::HostMirror hm_vertexx = Kokkos::create_mirror_view(globals.tiles[tile].field.vertexx);
+      Kokkos::deep_copy(hm_vertexx, globals.tiles[tile].field.vertexx);
 
-      for (int j=globals.chunk.tiles[tile].t_xmin+1; j <= globals.chunk.tiles[tile].t_xmax+1+1; ++j) {
+      for (int j=globals.tiles[tile].t_xmin+1; j <= globals.tiles[tile].t_xmax+1+1; ++j) {
         u << hm_vertexx(j) << std::endl;
       }
 
       u << "Y_COORDINATES " << nyv << " double" << std::endl;
 
-      typename Kokkos::View<double*>::HostMirror hm_vertexy = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.vertexy);
-      Kokkos::deep_copy(hm_vertexy, globals.chunk.tiles[tile].field.vertexy);
+      typename Kokkos::View<double*>::HostMirror hm_vertexy = Kokkos::create_mirror_view(globals.tiles[tile].field.vertexy);
+      Kokkos::deep_copy(hm_vertexy, globals.tiles[tile].field.vertexy);
 
-      for (int k = globals.chunk.tiles[tile].t_ymin+1; k <= globals.chunk.tiles[tile].t_ymax+1+1; ++k) {
+      for (int k = globals.tiles[tile].t_ymin+1; k <= globals.tiles[tile].t_ymax+1+1; ++k) {
         u << hm_vertexy(k) << std::endl;
       }
 
@@ -135,42 +135,42 @@ void visit(global_variables& globals, parallel_& parallel) {
       u << "CELL_DATA " << nxc*nyc << std::endl;
       u << "FIELD FieldData 4" << std::endl;
       u << "density 1 " << nxc*nyc << " double" << std::endl;
-      typename Kokkos::View<double**>::HostMirror hm_density0 = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.density0);
-      Kokkos::deep_copy(hm_density0, globals.chunk.tiles[tile].field.density0);
+      typename field_view::HostMirror hm_density0 = Kokkos::create_mirror_view(globals.tiles[tile].field.density0);
+      Kokkos::deep_copy(hm_density0, globals.tiles[tile].field.density0);
 
-      for (int k = globals.chunk.tiles[tile].t_ymin+1; k <= globals.chunk.tiles[tile].t_ymax+1; ++k) {
-        for (int j = globals.chunk.tiles[tile].t_xmin+1; j <= globals.chunk.tiles[tile].t_xmax+1; ++j) {
+      for (int k = globals.tiles[tile].t_ymin+1; k <= globals.tiles[tile].t_ymax+1; ++k) {
+        for (int j = globals.tiles[tile].t_xmin+1; j <= globals.tiles[tile].t_xmax+1; ++j) {
           u << std::scientific << std::setprecision(3) << hm_density0(j,k) << std::endl;
         }
       }
 
       u << "energy 1 " << nxc*nyc << " double" << std::endl;
-      typename Kokkos::View<double**>::HostMirror hm_energy0 = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.energy0);
-      Kokkos::deep_copy(hm_energy0, globals.chunk.tiles[tile].field.energy0);
+      typename field_view::HostMirror hm_energy0 = Kokkos::create_mirror_view(globals.tiles[tile].field.energy0);
+      Kokkos::deep_copy(hm_energy0, globals.tiles[tile].field.energy0);
 
-      for (int k = globals.chunk.tiles[tile].t_ymin+1; k <= globals.chunk.tiles[tile].t_ymax+1; ++k) {
-        for (int j = globals.chunk.tiles[tile].t_xmin+1; j <= globals.chunk.tiles[tile].t_xmax+1; ++j) {
+      for (int k = globals.tiles[tile].t_ymin+1; k <= globals.tiles[tile].t_ymax+1; ++k) {
+        for (int j = globals.tiles[tile].t_xmin+1; j <= globals.tiles[tile].t_xmax+1; ++j) {
           u << std::scientific << std::setprecision(3) << hm_energy0(j,k) << std::endl;
         }
       }
 
 
       u << "pressure 1 " << nxc*nyc << " double" << std::endl;
-      typename Kokkos::View<double**>::HostMirror hm_pressure = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.pressure);
-      Kokkos::deep_copy(hm_pressure, globals.chunk.tiles[tile].field.pressure);
+      typename field_view::HostMirror hm_pressure = Kokkos::create_mirror_view(globals.tiles[tile].field.pressure);
+      Kokkos::deep_copy(hm_pressure, globals.tiles[tile].field.pressure);
 
-      for (int k = globals.chunk.tiles[tile].t_ymin+1; k <= globals.chunk.tiles[tile].t_ymax+1; ++k) {
-        for (int j = globals.chunk.tiles[tile].t_xmin+1; j <= globals.chunk.tiles[tile].t_xmax+1; ++j) {
+      for (int k = globals.tiles[tile].t_ymin+1; k <= globals.tiles[tile].t_ymax+1; ++k) {
+        for (int j = globals.tiles[tile].t_xmin+1; j <= globals.tiles[tile].t_xmax+1; ++j) {
           u << std::scientific << std::setprecision(3) << hm_pressure(j,k) << std::endl;
         }
       }
 
       u << "viscosity 1 " << nxc*nyc << " double" << std::endl;
-      typename Kokkos::View<double**>::HostMirror hm_viscosity = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.viscosity);
-      Kokkos::deep_copy(hm_viscosity, globals.chunk.tiles[tile].field.viscosity);
+      typename work_view::HostMirror hm_viscosity = Kokkos::create_mirror_view(globals.tiles[tile].field.viscosity);
+      Kokkos::deep_copy(hm_viscosity, globals.tiles[tile].field.viscosity);
 
-      for (int k = globals.chunk.tiles[tile].t_ymin+1; k <= globals.chunk.tiles[tile].t_ymax+1; ++k) {
-        for (int j = globals.chunk.tiles[tile].t_xmin+1; j <= globals.chunk.tiles[tile].t_xmax+1; ++j) {
+      for (int k = globals.tiles[tile].t_ymin+1; k <= globals.tiles[tile].t_ymax+1; ++k) {
+        for (int j = globals.tiles[tile].t_xmin+1; j <= globals.tiles[tile].t_xmax+1; ++j) {
           double temp = (fabs(hm_viscosity(j,k)) > 0.00000001) ? hm_viscosity(j,k) : 0.0;
           u << std::scientific << std::setprecision(3) << temp << std::endl;
         }
@@ -179,21 +179,21 @@ void visit(global_variables& globals, parallel_& parallel) {
       u << "POINT_DATA " << nxv*nyv << std::endl;
       u << "FIELD FieldData 2" << std::endl;
       u << "x_vel 1 " << nxv*nyv << " double" << std::endl;
-      typename Kokkos::View<double**>::HostMirror hm_xvel0 = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.xvel0);
-      Kokkos::deep_copy(hm_xvel0, globals.chunk.tiles[tile].field.xvel0);
+      typename field_view::HostMirror hm_xvel0 = Kokkos::create_mirror_view(globals.tiles[tile].field.xvel0);
+      Kokkos::deep_copy(hm_xvel0, globals.tiles[tile].field.xvel0);
 
-      for (int k = globals.chunk.tiles[tile].t_ymin+1; k <= globals.chunk.tiles[tile].t_ymax+1+1; ++k) {
-        for (int j = globals.chunk.tiles[tile].t_xmin+1; j <= globals.chunk.tiles[tile].t_xmax+1+1; ++j) {
+      for (int k = globals.tiles[tile].t_ymin+1; k <= globals.tiles[tile].t_ymax+1+1; ++k) {
+        for (int j = globals.tiles[tile].t_xmin+1; j <= globals.tiles[tile].t_xmax+1+1; ++j) {
           double temp = (fabs(hm_xvel0(j,k)) > 0.00000001) ? hm_xvel0(j,k) : 0.0;
           u << std::scientific << std::setprecision(3) << temp << std::endl;
         }
       }
       u << "y_vel 1 " << nxv*nyv << " double" << std::endl;
-      typename Kokkos::View<double**>::HostMirror hm_yvel0 = Kokkos::create_mirror_view(globals.chunk.tiles[tile].field.yvel0);
-      Kokkos::deep_copy(hm_yvel0, globals.chunk.tiles[tile].field.yvel0);
+      typename field_view::HostMirror hm_yvel0 = Kokkos::create_mirror_view(globals.tiles[tile].field.yvel0);
+      Kokkos::deep_copy(hm_yvel0, globals.tiles[tile].field.yvel0);
 
-      for (int k = globals.chunk.tiles[tile].t_ymin+1; k <= globals.chunk.tiles[tile].t_ymax+1+1; ++k) {
-        for (int j = globals.chunk.tiles[tile].t_xmin+1; j <= globals.chunk.tiles[tile].t_xmax+1+1; ++j) {
+      for (int k = globals.tiles[tile].t_ymin+1; k <= globals.tiles[tile].t_ymax+1+1; ++k) {
+        for (int j = globals.tiles[tile].t_xmin+1; j <= globals.tiles[tile].t_xmax+1+1; ++j) {
           double temp = (fabs(hm_yvel0(j,k)) > 0.00000001) ? hm_yvel0(j,k) : 0.0;
           u << std::scientific << std::setprecision(3) << temp << std::endl;
         }
@@ -201,7 +201,7 @@ void visit(global_variables& globals, parallel_& parallel) {
       u.close();
     }
   }
-  if (globals.profiler_on) globals.profiler.visit += timer()-kernel_time;
+  profiler_stop(globals, globals.profiler.visit, kernel_time);
 
 }
 